@@ -0,0 +1,88 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Process-wide pool of worker threads for the numerical kernels.
+//
+// parallelFor() splits [0, n) into at most numThreads() contiguous chunks, and
+// chunk t always goes to thread t (the caller is thread 0), so kernels that
+// partition the same range see the same thread/row mapping every call.
+//
+// The pool size is read once from LA_NUM_THREADS, defaulting to
+// std::thread::hardware_concurrency(). Calls made from inside a running
+// parallelFor, or while another thread owns the pool, run serially on the
+// calling thread rather than block.
+//
+// LA_PIN_THREADS pins thread t to one CPU (Linux only): "compact" uses the
+// t-th CPU of the process affinity mask, a list such as "0,8,1,9" the t-th
+// entry (both wrap around). Thread 0 is whichever thread calls parallelFor;
+// it is pinned only while it runs its chunk and then gets its previous
+// affinity back, so callers keep their own. Together with the first-touch
+// initialisation in NumaMemory.hpp this keeps each chunk's data on the node
+// of the core that computes on it.
+class ComputePool {
+public:
+    using Body = std::function<void(std::size_t begin, std::size_t end)>;
+
+    static ComputePool& instance();
+
+    ComputePool(const ComputePool&) = delete;
+    ComputePool& operator=(const ComputePool&) = delete;
+    ~ComputePool();
+
+    std::size_t numThreads() const noexcept;
+    // CPU of each thread when LA_PIN_THREADS is set, empty otherwise
+    const std::vector<int>& pinnedCpus() const noexcept { return cpus_; }
+
+    // body(begin, end) over contiguous chunks of at least `grain` indices;
+    // the first exception thrown by any chunk is rethrown here
+    void parallelFor(std::size_t n, std::size_t grain, const Body& body);
+
+    // [begin, end) handed to thread t when [0, n) is split into `chunks`
+    static std::size_t chunkBegin(std::size_t n, std::size_t chunks, std::size_t t);
+
+    // While alive, parallelFor on the current thread runs serially, as if
+    // nested. For threads that run many small jobs side by side and must
+    // leave the pool to a large one.
+    class SerialScope {
+    public:
+        SerialScope();
+        ~SerialScope();
+        SerialScope(const SerialScope&) = delete;
+        SerialScope& operator=(const SerialScope&) = delete;
+
+    private:
+        bool prev_;
+    };
+
+private:
+    explicit ComputePool(std::size_t nthreads);
+
+    void workerLoop(std::size_t tid);
+    void runChunk(std::size_t tid);
+
+    std::vector<std::thread> workers_;
+    std::vector<int> cpus_;
+
+    std::mutex submit_;          // owned by the thread currently using the pool
+    std::mutex m_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    std::size_t generation_;
+    std::size_t pending_;
+    bool stop_;
+
+    // current job
+    const Body* body_;
+    std::size_t n_;
+    std::size_t chunks_;
+    std::exception_ptr error_;
+};
+
+// shorthand for ComputePool::instance().parallelFor(n, grain, body)
+void parallelFor(std::size_t n, std::size_t grain, const ComputePool::Body& body);
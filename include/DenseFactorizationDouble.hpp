@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+#include "DenseSquareMatrixDouble.hpp"
+#include "VectorDouble.hpp"
+
+// `stop`, when set, is polled before each column (LU) or row (Cholesky) of
+// the factorization; if it returns true FactorizationStopped is thrown. This
+// is how callers cancel a long factorization.
+using FactorizationStop = std::function<bool()>;
+
+class FactorizationStopped : public std::runtime_error {
+public:
+    FactorizationStopped() : std::runtime_error("Error: Factorization stopped by caller") {}
+};
+
+// LU factorization with partial pivoting, P A = L U. Factor once, then
+// solve() any number of right-hand sides. Throws on a zero pivot.
+class DenseLUDouble {
+public:
+    explicit DenseLUDouble(const DenseSquareMatrixDouble& A,
+                           const FactorizationStop& stop = nullptr);
+
+    std::size_t size() const noexcept;
+    VectorDouble solve(const VectorDouble& b) const;
+
+private:
+    DenseSquareMatrixDouble LU_;     // unit L below the diagonal, U on and above
+    std::vector<std::size_t> perm_;  // row i of P A is row perm_[i] of A
+};
+
+// Cholesky factorization A = L L^T of a symmetric positive definite matrix.
+// Only the lower triangle of A is read. Throws if A is not positive definite.
+class DenseCholeskyDouble {
+public:
+    explicit DenseCholeskyDouble(const DenseSquareMatrixDouble& A,
+                                 const FactorizationStop& stop = nullptr);
+
+    std::size_t size() const noexcept;
+    VectorDouble solve(const VectorDouble& b) const;
+
+private:
+    DenseSquareMatrixDouble L_;      // lower triangle
+};
@@ -21,6 +21,10 @@ public:
     double& operator()(std::size_t i, std::size_t j);
     const double& operator()(std::size_t i, std::size_t j) const;
 
+    // raw row-major storage, for the SIMD kernels
+    double* data() noexcept;
+    const double* data() const noexcept;
+
     // algebra
     DenseSquareMatrixDouble operator+(const DenseSquareMatrixDouble& other) const;
     DenseSquareMatrixDouble operator-(const DenseSquareMatrixDouble& other) const;
@@ -28,6 +32,12 @@ public:
     DenseSquareMatrixDouble operator*(double scalar) const;
     VectorDouble operator*(const VectorDouble& x) const;
 
+    // structure checks, tiled and run on the ComputePool with early exit.
+    // A(i,j) and A(j,i) match if |A(i,j) - A(j,i)| <= max(absTol, relTol * max(|A(i,j)|, |A(j,i)|))
+    bool isSymmetric(double absTol = 1e-12, double relTol = 0.0) const;
+    // |A(i,i)| >= (1 - relTol) * sum_{j != i} |A(i,j)| for every row
+    bool isDiagonallyDominant(double relTol = 0.0) const;
+
 private:
     std::size_t N_;
     std::unique_ptr<double[]> data_;
@@ -0,0 +1,84 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <mpi.h>
+#include "DistributedVectorDouble.hpp"
+
+// Row-partitioned sparse square matrix over an MPI communicator, with the same
+// row ownership as DistributedVectorDouble. Each rank assembles its own rows
+// with GLOBAL indices, then finalize() (collective) builds a local CRS block
+// whose columns are the owned rows followed by the ghost columns, plus the
+// halo-exchange plan: which ghost values come from which rank, and which
+// owned values each neighbour needs.
+//
+// multiply() posts the non-blocking halo exchange, computes the interior rows
+// (no ghost references) while it is in flight, then the boundary rows.
+// The halo buffers are members, so one matrix must not be applied from two
+// threads at once.
+//
+// Only built with -DLA_WITH_MPI (see src/DistributedSparseMatrixCRSDouble.cpp).
+class DistributedSparseMatrixCRSDouble {
+public:
+    DistributedSparseMatrixCRSDouble(MPI_Comm comm, std::size_t globalN);
+
+    MPI_Comm comm() const noexcept { return comm_; }
+    std::size_t globalSize() const noexcept { return N_; }
+    std::size_t localRows() const noexcept { return r1_ - r0_; }
+    std::size_t rowBegin() const noexcept { return r0_; }
+    std::size_t rowEnd() const noexcept { return r1_; }
+
+    // i must be owned by this rank, duplicates are summed
+    void addEntry(std::size_t i, std::size_t j, double val);
+    void finalize(); // collective
+
+    // y = A * x, collective
+    void multiply(const DistributedVectorDouble& x, DistributedVectorDouble& y) const;
+    DistributedVectorDouble operator*(const DistributedVectorDouble& x) const;
+    // same on the owned slices (x.local(), y.local()), collective
+    void multiplyLocal(const VectorDouble& x, VectorDouble& y) const;
+
+    std::size_t numGhosts() const noexcept { return ghostGlobal_.size(); }
+    std::size_t numInteriorRows() const noexcept { return interiorRows_.size(); }
+    std::size_t numNeighbours() const noexcept { return recvRanks_.size(); }
+
+private:
+    struct Triplet {
+        std::size_t i; // local row
+        std::size_t j; // global column
+        double v;
+    };
+
+    void multiplyRows(const std::vector<std::size_t>& rows, const double* xExt, double* y) const;
+    void checkVector(const DistributedVectorDouble& v) const;
+
+    MPI_Comm comm_;
+    std::size_t N_;
+    int rank_;
+    int nprocs_;
+    std::size_t r0_, r1_;
+
+    // builder storage
+    std::vector<Triplet> entries_;
+    bool finalized_;
+
+    // local CRS, columns in [0, localRows) are owned, the rest are ghosts
+    std::vector<std::size_t> rowPtr_;
+    std::vector<std::size_t> colInd_;
+    std::vector<double> val_;
+    std::vector<double> diag_;
+    std::vector<std::size_t> interiorRows_;
+    std::vector<std::size_t> boundaryRows_;
+
+    // halo plan; ghosts are sorted by global index, so each neighbour's
+    // values land in one contiguous range of the ghost block
+    std::vector<std::size_t> ghostGlobal_;
+    std::vector<int> recvRanks_;
+    std::vector<std::size_t> recvOffsets_; // recvRanks_.size() + 1
+    std::vector<int> sendRanks_;
+    std::vector<std::size_t> sendOffsets_; // sendRanks_.size() + 1
+    std::vector<std::size_t> sendIdx_;     // local rows to pack
+
+    // owned x followed by the received ghosts
+    mutable std::vector<double> xExt_;
+    mutable std::vector<double> sendBuf_;
+};
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <mpi.h>
+#include "VectorDouble.hpp"
+
+// Row-partitioned vector over an MPI communicator. Rank r owns the contiguous
+// global rows [rowBegin(N, P, r), rowBegin(N, P, r + 1)), the first N % P ranks
+// holding one extra row. Element access is by LOCAL index; dot() and the norms
+// are collective over the communicator.
+//
+// Only built with -DLA_WITH_MPI (see src/DistributedVectorDouble.cpp).
+class DistributedVectorDouble {
+public:
+    DistributedVectorDouble(MPI_Comm comm, std::size_t globalSize);
+
+    MPI_Comm comm() const noexcept { return comm_; }
+    std::size_t globalSize() const noexcept { return N_; }
+    std::size_t localSize() const noexcept { return local_.size(); }
+    std::size_t rowBegin() const noexcept { return r0_; }
+    std::size_t rowEnd() const noexcept { return r0_ + local_.size(); }
+
+    // first global row of rank r when N rows are split over P ranks
+    static std::size_t rowBegin(std::size_t N, int P, int r);
+
+    double& operator[](std::size_t i) { return local_[i]; }
+    const double& operator[](std::size_t i) const { return local_[i]; }
+
+    VectorDouble& local() noexcept { return local_; }
+    const VectorDouble& local() const noexcept { return local_; }
+
+    DistributedVectorDouble operator+(const DistributedVectorDouble& other) const;
+    DistributedVectorDouble operator-(const DistributedVectorDouble& other) const;
+    DistributedVectorDouble operator*(double scalar) const;
+    void axpy(double alpha, const DistributedVectorDouble& x);
+
+    // global reductions (MPI_Allreduce)
+    double dot(const DistributedVectorDouble& other) const;
+    double norm2() const;
+    double normInf() const;
+
+private:
+    DistributedVectorDouble(MPI_Comm comm, std::size_t N, std::size_t r0, VectorDouble&& local);
+    void checkCompatible(const DistributedVectorDouble& other) const;
+
+    MPI_Comm comm_;
+    std::size_t N_;
+    std::size_t r0_;
+    VectorDouble local_;
+};
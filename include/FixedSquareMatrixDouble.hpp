@@ -0,0 +1,263 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include "DenseSquareMatrixDouble.hpp"
+#include "FixedVectorDouble.hpp"
+
+// N x N row-major matrix stored inline, the fixed-size counterpart of
+// DenseSquareMatrixDouble for 2x2 .. 8x8 systems. Like FixedVectorDouble it is
+// header-only and all loops have compile-time trip counts and LA_FIXED_UNROLL.
+//
+// determinant() and solve() use closed forms (cofactors / Cramer's rule) for
+// N <= 3 and an LU with partial pivoting above that. Its triangular loops run
+// over all N with a guard instead of a column-dependent bound, so they have
+// fixed trip counts too and unroll completely. solve() throws
+// on a singular matrix (zero determinant or zero pivot), as DenseLUDouble does.
+template <std::size_t N>
+class FixedSquareMatrixDouble {
+    static_assert(N > 0, "FixedSquareMatrixDouble needs N > 0");
+
+public:
+    static constexpr std::size_t Size = N;
+
+    FixedSquareMatrixDouble() : a_{} {}
+
+    static FixedSquareMatrixDouble identity()
+    {
+        FixedSquareMatrixDouble I;
+        LA_FIXED_UNROLL
+        for (std::size_t i = 0; i < N; ++i)
+            I.a_[i * N + i] = 1.0;
+        return I;
+    }
+
+    // from a DenseSquareMatrixDouble of size N, throws otherwise
+    explicit FixedSquareMatrixDouble(const DenseSquareMatrixDouble& A)
+    {
+        if (A.size() != N)
+            throw std::runtime_error("Error: Dimension mismatch converting to FixedSquareMatrixDouble");
+        const double* d = A.data();
+        LA_FIXED_UNROLL
+        for (std::size_t k = 0; k < N * N; ++k)
+            a_[k] = d[k];
+    }
+
+    DenseSquareMatrixDouble toDense() const
+    {
+        DenseSquareMatrixDouble A(N);
+        double* d = A.data();
+        LA_FIXED_UNROLL
+        for (std::size_t k = 0; k < N * N; ++k)
+            d[k] = a_[k];
+        return A;
+    }
+
+    static constexpr std::size_t size() noexcept { return N; }
+
+    double& operator()(std::size_t i, std::size_t j) { return a_[i * N + j]; }
+    const double& operator()(std::size_t i, std::size_t j) const { return a_[i * N + j]; }
+
+    double* data() noexcept { return a_; }
+    const double* data() const noexcept { return a_; }
+
+    FixedSquareMatrixDouble operator+(const FixedSquareMatrixDouble& o) const
+    {
+        FixedSquareMatrixDouble r;
+        LA_FIXED_UNROLL
+        for (std::size_t k = 0; k < N * N; ++k)
+            r.a_[k] = a_[k] + o.a_[k];
+        return r;
+    }
+
+    FixedSquareMatrixDouble operator-(const FixedSquareMatrixDouble& o) const
+    {
+        FixedSquareMatrixDouble r;
+        LA_FIXED_UNROLL
+        for (std::size_t k = 0; k < N * N; ++k)
+            r.a_[k] = a_[k] - o.a_[k];
+        return r;
+    }
+
+    FixedSquareMatrixDouble operator*(double s) const
+    {
+        FixedSquareMatrixDouble r;
+        LA_FIXED_UNROLL
+        for (std::size_t k = 0; k < N * N; ++k)
+            r.a_[k] = a_[k] * s;
+        return r;
+    }
+
+    FixedSquareMatrixDouble operator*(const FixedSquareMatrixDouble& o) const
+    {
+        FixedSquareMatrixDouble r;
+        LA_FIXED_UNROLL
+        for (std::size_t i = 0; i < N; ++i)
+            LA_FIXED_UNROLL
+            for (std::size_t k = 0; k < N; ++k) {
+                const double aik = a_[i * N + k];
+                LA_FIXED_UNROLL
+                for (std::size_t j = 0; j < N; ++j)
+                    r.a_[i * N + j] += aik * o.a_[k * N + j];
+            }
+        return r;
+    }
+
+    FixedVectorDouble<N> operator*(const FixedVectorDouble<N>& x) const
+    {
+        FixedVectorDouble<N> y;
+        LA_FIXED_UNROLL
+        for (std::size_t i = 0; i < N; ++i) {
+            double s = 0.0;
+            LA_FIXED_UNROLL
+            for (std::size_t j = 0; j < N; ++j)
+                s += a_[i * N + j] * x[j];
+            y[i] = s;
+        }
+        return y;
+    }
+
+    // r = b - A * x
+    FixedVectorDouble<N> residual(const FixedVectorDouble<N>& x, const FixedVectorDouble<N>& b) const
+    {
+        return b - (*this) * x;
+    }
+
+    double determinant() const
+    {
+        if constexpr (N == 1) {
+            return a_[0];
+        } else if constexpr (N == 2) {
+            return a_[0] * a_[3] - a_[1] * a_[2];
+        } else if constexpr (N == 3) {
+            return a_[0] * (a_[4] * a_[8] - a_[5] * a_[7])
+                 - a_[1] * (a_[3] * a_[8] - a_[5] * a_[6])
+                 + a_[2] * (a_[3] * a_[7] - a_[4] * a_[6]);
+        } else {
+            FixedSquareMatrixDouble lu = *this;
+            std::size_t perm[N];
+            bool odd = false;
+            if (!lu.factorLU(perm, odd))
+                return 0.0;
+            double det = odd ? -1.0 : 1.0;
+            LA_FIXED_UNROLL
+            for (std::size_t i = 0; i < N; ++i)
+                det *= lu.a_[i * N + i];
+            return det;
+        }
+    }
+
+    // x = A \ b
+    FixedVectorDouble<N> solve(const FixedVectorDouble<N>& b) const
+    {
+        FixedVectorDouble<N> x;
+        if constexpr (N == 1) {
+            if (a_[0] == 0.0)
+                throw std::runtime_error("Error: Singular matrix in fixed-size solve");
+            x[0] = b[0] / a_[0];
+        } else if constexpr (N == 2) {
+            const double det = determinant();
+            if (det == 0.0)
+                throw std::runtime_error("Error: Singular matrix in fixed-size solve");
+            const double inv = 1.0 / det;
+            x[0] = (a_[3] * b[0] - a_[1] * b[1]) * inv;
+            x[1] = (a_[0] * b[1] - a_[2] * b[0]) * inv;
+        } else if constexpr (N == 3) {
+            // adjugate times b
+            const double c00 = a_[4] * a_[8] - a_[5] * a_[7];
+            const double c01 = a_[5] * a_[6] - a_[3] * a_[8];
+            const double c02 = a_[3] * a_[7] - a_[4] * a_[6];
+            const double det = a_[0] * c00 + a_[1] * c01 + a_[2] * c02;
+            if (det == 0.0)
+                throw std::runtime_error("Error: Singular matrix in fixed-size solve");
+            const double inv = 1.0 / det;
+            const double c10 = a_[2] * a_[7] - a_[1] * a_[8];
+            const double c11 = a_[0] * a_[8] - a_[2] * a_[6];
+            const double c12 = a_[1] * a_[6] - a_[0] * a_[7];
+            const double c20 = a_[1] * a_[5] - a_[2] * a_[4];
+            const double c21 = a_[2] * a_[3] - a_[0] * a_[5];
+            const double c22 = a_[0] * a_[4] - a_[1] * a_[3];
+            x[0] = (c00 * b[0] + c10 * b[1] + c20 * b[2]) * inv;
+            x[1] = (c01 * b[0] + c11 * b[1] + c21 * b[2]) * inv;
+            x[2] = (c02 * b[0] + c12 * b[1] + c22 * b[2]) * inv;
+        } else {
+            FixedSquareMatrixDouble lu = *this;
+            std::size_t perm[N];
+            bool odd = false;
+            if (!lu.factorLU(perm, odd))
+                throw std::runtime_error("Error: Singular matrix in fixed-size solve");
+
+            // forward substitution with unit L, then backward with U
+            LA_FIXED_UNROLL
+            for (std::size_t i = 0; i < N; ++i) {
+                double s = b[perm[i]];
+                LA_FIXED_UNROLL
+                for (std::size_t j = 0; j < N; ++j)
+                    if (j < i)
+                        s -= lu.a_[i * N + j] * x[j];
+                x[i] = s;
+            }
+            LA_FIXED_UNROLL
+            for (std::size_t k = 0; k < N; ++k) {
+                const std::size_t i = N - 1 - k;
+                double s = x[i];
+                LA_FIXED_UNROLL
+                for (std::size_t j = 0; j < N; ++j)
+                    if (j > i)
+                        s -= lu.a_[i * N + j] * x[j];
+                x[i] = s / lu.a_[i * N + i];
+            }
+        }
+        return x;
+    }
+
+private:
+    // in-place P A = L U (unit L below the diagonal); row i of P A is row
+    // perm[i] of A. Returns false on a zero pivot.
+    bool factorLU(std::size_t (&perm)[N], bool& odd)
+    {
+        LA_FIXED_UNROLL
+        for (std::size_t i = 0; i < N; ++i)
+            perm[i] = i;
+
+        LA_FIXED_UNROLL
+        for (std::size_t c = 0; c < N; ++c) {
+            std::size_t p = c;
+            double best = std::abs(a_[c * N + c]);
+            LA_FIXED_UNROLL
+            for (std::size_t r = 0; r < N; ++r) {
+                const double v = std::abs(a_[r * N + c]);
+                if (r > c && v > best) {
+                    best = v;
+                    p = r;
+                }
+            }
+            if (best == 0.0)
+                return false;
+            if (p != c) {
+                LA_FIXED_UNROLL
+                for (std::size_t j = 0; j < N; ++j)
+                    std::swap(a_[c * N + j], a_[p * N + j]);
+                std::swap(perm[c], perm[p]);
+                odd = !odd;
+            }
+
+            const double inv = 1.0 / a_[c * N + c];
+            LA_FIXED_UNROLL
+            for (std::size_t r = 0; r < N; ++r) {
+                if (r <= c)
+                    continue;
+                const double l = a_[r * N + c] * inv;
+                a_[r * N + c] = l;
+                LA_FIXED_UNROLL
+                for (std::size_t j = 0; j < N; ++j)
+                    if (j > c)
+                        a_[r * N + j] -= l * a_[c * N + j];
+            }
+        }
+        return true;
+    }
+
+    double a_[N * N];
+};
@@ -0,0 +1,110 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include "VectorDouble.hpp"
+
+// Vector of N doubles stored inline (stack / inside other objects), for small
+// systems where VectorDouble's heap allocation and size checks dominate. N is a
+// compile-time constant, so every loop has a fixed trip count; each carries
+// LA_FIXED_UNROLL and is fully unrolled by GCC and Clang. There are no size
+// checks except when converting from VectorDouble.
+//
+// Header-only on purpose: the point is that the operations inline into the
+// caller, which an explicit instantiation in a .cpp would prevent.
+
+// complete unrolling of the fixed trip-count loops, up to 8x8 = 64 iterations
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 8)
+#define LA_FIXED_UNROLL _Pragma("GCC unroll 64")
+#else
+#define LA_FIXED_UNROLL
+#endif
+
+template <std::size_t N>
+class FixedVectorDouble {
+    static_assert(N > 0, "FixedVectorDouble needs N > 0");
+
+public:
+    static constexpr std::size_t Size = N;
+
+    FixedVectorDouble() : v_{} {}
+
+    // from a VectorDouble of size N, throws otherwise
+    explicit FixedVectorDouble(const VectorDouble& x)
+    {
+        if (x.size() != N)
+            throw std::runtime_error("Error: Dimension mismatch converting to FixedVectorDouble");
+        LA_FIXED_UNROLL
+        for (std::size_t i = 0; i < N; ++i)
+            v_[i] = x[i];
+    }
+
+    VectorDouble toVector() const
+    {
+        VectorDouble x(N);
+        LA_FIXED_UNROLL
+        for (std::size_t i = 0; i < N; ++i)
+            x[i] = v_[i];
+        return x;
+    }
+
+    static constexpr std::size_t size() noexcept { return N; }
+
+    double& operator[](std::size_t i) { return v_[i]; }
+    const double& operator[](std::size_t i) const { return v_[i]; }
+
+    double* data() noexcept { return v_; }
+    const double* data() const noexcept { return v_; }
+
+    FixedVectorDouble operator+(const FixedVectorDouble& o) const
+    {
+        FixedVectorDouble r;
+        LA_FIXED_UNROLL
+        for (std::size_t i = 0; i < N; ++i)
+            r.v_[i] = v_[i] + o.v_[i];
+        return r;
+    }
+
+    FixedVectorDouble operator-(const FixedVectorDouble& o) const
+    {
+        FixedVectorDouble r;
+        LA_FIXED_UNROLL
+        for (std::size_t i = 0; i < N; ++i)
+            r.v_[i] = v_[i] - o.v_[i];
+        return r;
+    }
+
+    FixedVectorDouble operator*(double s) const
+    {
+        FixedVectorDouble r;
+        LA_FIXED_UNROLL
+        for (std::size_t i = 0; i < N; ++i)
+            r.v_[i] = v_[i] * s;
+        return r;
+    }
+
+    double dot(const FixedVectorDouble& o) const
+    {
+        double s = 0.0;
+        LA_FIXED_UNROLL
+        for (std::size_t i = 0; i < N; ++i)
+            s += v_[i] * o.v_[i];
+        return s;
+    }
+
+    double normInf() const
+    {
+        // NaN is sticky, as in VectorDouble::normInf
+        double m = 0.0;
+        LA_FIXED_UNROLL
+        for (std::size_t i = 0; i < N; ++i) {
+            const double a = std::abs(v_[i]);
+            if (a > m || std::isnan(a))
+                m = a;
+        }
+        return m;
+    }
+
+private:
+    double v_[N];
+};
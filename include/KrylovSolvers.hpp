@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include "LinearOperatorDouble.hpp"
+#include "VectorDouble.hpp"
+
+// Krylov solvers for A x = b against any LinearOperatorDouble, starting from
+// the x passed in. They stop when ||b - A x||_2 <= relTol * ||b||_2 and return
+// the number of iterations taken. They throw std::runtime_error if maxIter is
+// reached first, and KrylovBreakdown if the method itself breaks down (CG on
+// an operator that is not SPD, GMRES on a singular one).
+//
+// `stop`, when set, is polled once per iteration. If it returns true the solve
+// is abandoned: KrylovStopped is thrown and x holds the last iterate. This is
+// how callers implement cancellation and deadlines.
+//
+// `dot`, when set, replaces every inner product x.dot(y). With A applying to
+// the locally owned rows and a dot that sums over all ranks, the same solvers
+// run on row-distributed systems (see LinearSystemSparseDistributed).
+using KrylovStop = std::function<bool()>;
+using KrylovDot = std::function<double(const VectorDouble&, const VectorDouble&)>;
+
+class KrylovStopped : public std::runtime_error {
+public:
+    KrylovStopped() : std::runtime_error("Error: Krylov solve stopped by caller") {}
+};
+
+class KrylovBreakdown : public std::runtime_error {
+public:
+    explicit KrylovBreakdown(const char* what) : std::runtime_error(what) {}
+};
+
+// Conjugate gradients, A symmetric positive definite (throws on breakdown)
+std::size_t solveCG(const LinearOperatorDouble& A, const VectorDouble& b, VectorDouble& x,
+                    double relTol = 1e-10, std::size_t maxIter = 1000,
+                    const KrylovStop& stop = nullptr, const KrylovDot& dot = nullptr);
+
+// Preconditioned CG. M applies the inverse of an SPD preconditioner, z = M r.
+// The same M can be reused for any number of solves with A.
+std::size_t solvePCG(const LinearOperatorDouble& A, const LinearOperatorDouble& M,
+                     const VectorDouble& b, VectorDouble& x,
+                     double relTol = 1e-10, std::size_t maxIter = 1000,
+                     const KrylovStop& stop = nullptr, const KrylovDot& dot = nullptr);
+
+// Restarted GMRES(restart) with modified Gram-Schmidt and Givens rotations
+std::size_t solveGMRES(const LinearOperatorDouble& A, const VectorDouble& b, VectorDouble& x,
+                       double relTol = 1e-10, std::size_t maxIter = 1000,
+                       std::size_t restart = 30, const KrylovStop& stop = nullptr,
+                       const KrylovDot& dot = nullptr);
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include "DenseSquareMatrixDouble.hpp"
+#include "SparseSquareMatrixCRSDouble.hpp"
+#include "VectorDouble.hpp"
+
+// Abstract square linear operator y = A x. Solvers and residuals written
+// against this interface run unchanged on assembled matrices and on
+// matrix-free operators (see StencilOperatorDouble.hpp).
+class LinearOperatorDouble {
+public:
+    virtual ~LinearOperatorDouble() = default;
+
+    virtual std::size_t size() const noexcept = 0;
+
+    // y = A * x, x and y already have size() entries and do not alias
+    virtual void apply(const VectorDouble& x, VectorDouble& y) const = 0;
+
+    VectorDouble operator*(const VectorDouble& x) const;
+};
+
+// adapter exposing an assembled CRS matrix through LinearOperatorDouble
+class SparseMatrixOperatorDouble : public LinearOperatorDouble {
+public:
+    explicit SparseMatrixOperatorDouble(SparseSquareMatrixCRSDouble&& A);
+
+    std::size_t size() const noexcept override;
+    void apply(const VectorDouble& x, VectorDouble& y) const override;
+
+    const SparseSquareMatrixCRSDouble& matrix() const { return A_; }
+
+private:
+    SparseSquareMatrixCRSDouble A_;
+};
+
+// adapter exposing a dense matrix through LinearOperatorDouble
+class DenseMatrixOperatorDouble : public LinearOperatorDouble {
+public:
+    explicit DenseMatrixOperatorDouble(DenseSquareMatrixDouble&& A);
+
+    std::size_t size() const noexcept override;
+    void apply(const VectorDouble& x, VectorDouble& y) const override;
+
+    const DenseSquareMatrixDouble& matrix() const { return A_; }
+
+private:
+    DenseSquareMatrixDouble A_;
+};
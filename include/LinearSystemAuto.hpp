@@ -0,0 +1,64 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include "DenseSquareMatrixDouble.hpp"
+#include "SparseSquareMatrixCRSDouble.hpp"
+#include "VectorDouble.hpp"
+#include "LinearOperatorDouble.hpp"
+#include "DenseFactorizationDouble.hpp"
+#include "MatrixAnalysis.hpp"
+
+// Linear equation set A x = b that picks its own storage and solver.
+//
+// The constructor analyzes A once (MatrixAnalysis), selects a SolverPlan and
+// converts A to the chosen format: a mostly-zero dense matrix becomes CRS (or
+// BSR), a small or dense-enough CRS matrix becomes dense. Factorizations are
+// built on the first solve() and reused for later right-hand sides, so the
+// matrix is immutable after construction.
+//
+// If the plan's first choice fails (Cholesky on a matrix that is not positive
+// definite, CG breakdown) solve() falls back to LU / GMRES and records that
+// in plan(). Running out of iterations is not a failure of the choice: the
+// solver's exception propagates and the plan is kept.
+class LinearSystemAuto {
+public:
+    explicit LinearSystemAuto(DenseSquareMatrixDouble&& A, VectorDouble&& x, VectorDouble&& b);
+    explicit LinearSystemAuto(SparseSquareMatrixCRSDouble&& A, VectorDouble&& x, VectorDouble&& b);
+
+    std::size_t size() const noexcept;
+
+    VectorDouble& x();
+    VectorDouble& b();
+    const VectorDouble& x() const;
+    const VectorDouble& b() const;
+
+    const MatrixAnalysis& analysis() const noexcept { return analysis_; }
+    const SolverPlan& plan() const noexcept { return plan_; }
+
+    // compute b = A * x
+    void multiply();
+    // r = b - A * x
+    VectorDouble residual() const;
+
+    // x = A \ b with the planned solver; relTol and maxIter apply to the
+    // iterative paths only. Returns the iteration count (0 for direct solves).
+    std::size_t solve(double relTol = 1e-10, std::size_t maxIter = 1000);
+
+private:
+    void build(DenseSquareMatrixDouble* dense, SparseSquareMatrixCRSDouble* sparse);
+    void applyA(const VectorDouble& x, VectorDouble& y) const;
+
+    MatrixAnalysis analysis_;
+    SolverPlan plan_;
+
+    // exactly one of these holds A
+    std::unique_ptr<DenseSquareMatrixDouble> dense_;
+    std::unique_ptr<LinearOperatorDouble> op_;
+
+    // cached factorizations for the direct paths
+    std::unique_ptr<DenseLUDouble> lu_;
+    std::unique_ptr<DenseCholeskyDouble> chol_;
+
+    VectorDouble x_;
+    VectorDouble b_;
+};
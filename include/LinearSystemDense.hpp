@@ -18,11 +18,12 @@ public:
     void multiply();
     // r = b - A * x
     VectorDouble residual() const;
-    // solve x = A / b
-    // VectorDouble solve() const;
+    // solve x = A / b, see DenseFactorizationDouble.hpp to keep the factors
+    void solveLU();
+    void solveCholesky(); // A symmetric positive definite
 
-    bool isSymmetric() const;
-    bool isDiagonallyDominant() const;
+    bool isSymmetric(double absTol = 1e-12, double relTol = 0.0) const;
+    bool isDiagonallyDominant(double relTol = 0.0) const;
 
 private:
     DenseSquareMatrixDouble A_;
@@ -0,0 +1,66 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "DenseSquareMatrixDouble.hpp"
+#include "VectorDouble.hpp"
+
+// Many independent N x N dense systems A_s x_s = b_s of the same size, stored
+// contiguously instead of as one heap-backed LinearSystemDense each.
+//
+// Layout is interleaved by groups of Lanes systems (AoSoA): element (i, j) of
+// system s sits at [((s / Lanes) * N*N + i*N + j) * Lanes + s % Lanes], so every
+// kernel runs its innermost loop across Lanes systems at once and vectorizes
+// over the batch dimension. Groups are spread over the ComputePool threads.
+// The tail group is padded with identity systems.
+//
+// The kernels are plain loops compiled for the build's target ISA; they are
+// not in the SimdDispatch table, so on a baseline x86-64 build the 8 lanes
+// run as 4 SSE2 pairs even on an AVX-512 machine.
+class LinearSystemDenseBatched {
+public:
+    static constexpr std::size_t Lanes = 8;
+
+    LinearSystemDenseBatched(std::size_t N, std::size_t count);
+
+    std::size_t size() const noexcept;   // N
+    std::size_t count() const noexcept;  // number of systems
+
+    // element access for system s
+    double& A(std::size_t s, std::size_t i, std::size_t j);
+    double& x(std::size_t s, std::size_t i);
+    double& b(std::size_t s, std::size_t i);
+
+    const double& A(std::size_t s, std::size_t i, std::size_t j) const;
+    const double& x(std::size_t s, std::size_t i) const;
+    const double& b(std::size_t s, std::size_t i) const;
+
+    // interop with the single-system classes
+    void setSystem(std::size_t s, const DenseSquareMatrixDouble& A,
+                   const VectorDouble& x, const VectorDouble& b);
+    VectorDouble getX(std::size_t s) const;
+
+    // b_s = A_s * x_s for all s
+    void multiply();
+    // r_s = b_s - A_s * x_s for one system
+    VectorDouble residual(std::size_t s) const;
+    // ||b_s - A_s * x_s||_inf for all s, one entry per system (NaN if the
+    // residual of that system has a NaN)
+    VectorDouble residualNormInf() const;
+
+    // x_s = A_s \ b_s for all s; A and b are left untouched
+    void solveLU();        // partial pivoting
+    void solveCholesky();  // A_s symmetric positive definite
+
+private:
+    // flat position of entry k of system s, per = entries per system
+    static std::size_t index(std::size_t s, std::size_t k, std::size_t per) noexcept;
+    void checkSystem(std::size_t s) const;
+
+    std::size_t N_;
+    std::size_t count_;
+    std::size_t groups_;
+
+    std::vector<double> A_;
+    std::vector<double> x_;
+    std::vector<double> b_;
+};
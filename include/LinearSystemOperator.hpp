@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include "LinearOperatorDouble.hpp"
+#include "VectorDouble.hpp"
+
+// Linear equation set A x = b where A is any LinearOperatorDouble: an
+// assembled matrix behind SparseMatrixOperatorDouble or a matrix-free stencil.
+class LinearSystemOperator {
+public:
+    explicit LinearSystemOperator(std::unique_ptr<LinearOperatorDouble> A,
+                                  VectorDouble&& x,
+                                  VectorDouble&& b);
+
+    const LinearOperatorDouble& A() const;
+    VectorDouble& x();
+    VectorDouble& b();
+
+    const VectorDouble& x() const;
+    const VectorDouble& b() const;
+
+    // compute b = A * x
+    void multiply();
+    // r = b - A * x
+    VectorDouble residual() const;
+
+    // Conjugate gradients from the current x, A must be SPD.
+    // Stops when ||r||_2 <= relTol * ||b||_2 and returns the iteration count.
+    std::size_t solveCG(double relTol = 1e-10, std::size_t maxIter = 1000);
+
+    // Restarted GMRES(restart) from the current x for general A, same
+    // stopping rule; returns the total number of inner iterations.
+    std::size_t solveGMRES(double relTol = 1e-10, std::size_t maxIter = 1000,
+                           std::size_t restart = 30);
+
+private:
+    std::unique_ptr<LinearOperatorDouble> A_;
+    VectorDouble x_;
+    VectorDouble b_;
+};
@@ -21,6 +21,9 @@ public:
     void multiply();
     VectorDouble residual() const;
 
+    bool isSymmetric(double absTol = 1e-12, double relTol = 0.0) const;
+    bool isDiagonallyDominant(double relTol = 0.0) const;
+
 private:
     SparseSquareMatrixCRSDouble A_;
     VectorDouble x_;
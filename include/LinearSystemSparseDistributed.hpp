@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include "DistributedSparseMatrixCRSDouble.hpp"
+#include "DistributedVectorDouble.hpp"
+
+// Linear equation set A x = b distributed by rows over an MPI communicator.
+// Every member function is collective.
+//
+// Only built with -DLA_WITH_MPI (see src/LinearSystemSparseDistributed.cpp).
+class LinearSystemSparseDistributed {
+public:
+    explicit LinearSystemSparseDistributed(DistributedSparseMatrixCRSDouble&& A,
+                                           DistributedVectorDouble&& x,
+                                           DistributedVectorDouble&& b);
+
+    DistributedSparseMatrixCRSDouble& A();
+    DistributedVectorDouble& x();
+    DistributedVectorDouble& b();
+
+    const DistributedSparseMatrixCRSDouble& A() const;
+    const DistributedVectorDouble& x() const;
+    const DistributedVectorDouble& b() const;
+
+    // compute b = A * x
+    void multiply();
+    // r = b - A * x
+    DistributedVectorDouble residual() const;
+
+    // Conjugate gradients from the current x, A must be SPD.
+    // Stops when ||r||_2 <= relTol * ||b||_2 and returns the iteration count.
+    std::size_t solveCG(double relTol = 1e-10, std::size_t maxIter = 1000);
+
+private:
+    DistributedSparseMatrixCRSDouble A_;
+    DistributedVectorDouble x_;
+    DistributedVectorDouble b_;
+};
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include "DenseSquareMatrixDouble.hpp"
+#include "SparseSquareMatrixCRSDouble.hpp"
+
+// Structural and numerical properties of a square matrix, computed in one
+// pass (plus the symmetry / dominance checks) and then reused for format and
+// solver selection. Entries count as nonzero when they are != 0.
+struct MatrixAnalysis {
+    std::size_t n = 0;
+    std::size_t nnz = 0;            // including nonzero diagonal entries
+    double density = 0.0;           // nnz / n^2
+
+    bool symmetric = false;
+    bool diagonallyDominant = false;
+    bool positiveDiagonal = false;  // every A(i,i) > 0
+
+    std::size_t bandwidth = 0;      // max |i - j| over nonzeros
+    std::size_t minRowNnz = 0;
+    std::size_t maxRowNnz = 0;
+    double meanRowNnz = 0.0;
+    double stddevRowNnz = 0.0;
+
+    // largest B in {4, 3, 2} dividing n whose nonzero B x B blocks are on
+    // average at least 75% full, 1 if none
+    std::size_t blockSize = 1;
+
+    static MatrixAnalysis analyze(const DenseSquareMatrixDouble& A);
+    static MatrixAnalysis analyze(const SparseSquareMatrixCRSDouble& A);
+};
+
+enum class StorageFormat {
+    Dense,
+    CRS,
+    BSR     // SparseSquareMatrixBSRDouble<blockSize>
+};
+
+enum class SolverKind {
+    LU,
+    Cholesky,
+    CG,
+    GMRES
+};
+
+struct SolverPlan {
+    StorageFormat format = StorageFormat::CRS;
+    std::size_t blockSize = 1;
+    SolverKind solver = SolverKind::GMRES;
+};
+
+// Heuristic choice of storage and solver:
+//  - small, or dense enough and small enough to factor: dense storage with
+//    Cholesky (symmetric, positive diagonal) or LU;
+//  - otherwise CRS, or BSR when the pattern is blocked, with CG for symmetric
+//    matrices with a positive diagonal and GMRES for everything else.
+SolverPlan selectSolverPlan(const MatrixAnalysis& a);
+
+const char* storageFormatName(StorageFormat f);
+const char* solverKindName(SolverKind s);
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// NUMA placement helpers.
+//
+// Linux places a page on the node of the thread that first writes it. The
+// vector and matrix constructors therefore allocate without touching and then
+// initialise through parallelFor with kRowGrain, the same grain the
+// row-parallel kernels (dense A*x and A*B, CRS SpMV) use: both see the same
+// ComputePool chunk -> thread mapping, so each thread computes on pages it
+// touched. With LA_PIN_THREADS set (see ComputePool.hpp) that mapping is
+// also fixed to cores, and therefore to nodes.
+//
+// Arrays shorter than kFirstTouchMin elements are filled serially; they live
+// in cache and the pool dispatch would cost more than it saves.
+
+// rows (or elements) per chunk shared by first touch and row-parallel kernels
+constexpr std::size_t kRowGrain = 64;
+constexpr std::size_t kFirstTouchMin = std::size_t(1) << 15;
+
+// p[0, n) = value, first-touched in ComputePool chunks of n
+void firstTouchFill(double* p, std::size_t n, double value);
+// dst[0, n) = src[0, n), first-touched in ComputePool chunks of n
+void firstTouchCopy(double* dst, const double* src, std::size_t n);
+// the same for a row-major rows x cols block, chunked by rows
+void firstTouchFillRows(double* p, std::size_t rows, std::size_t cols, double value);
+void firstTouchCopyRows(double* dst, const double* src, std::size_t rows, std::size_t cols);
+
+// number of NUMA nodes the kernel reports, 1 when unknown
+int numaNodeCount();
+
+// Bind the whole pages of [p, p + bytes) to `node`, migrating pages that are
+// already resident (mbind MPOL_BIND | MPOL_MF_MOVE). Returns false when the
+// platform or the kernel refuses; the memory is still usable. Partial pages at
+// either end are left alone, so bind page-sized or larger buffers.
+bool numaBind(void* p, std::size_t bytes, int node);
+
+// std::allocator that default-initialises on value-less construction, so
+// vector::resize() allocates without writing and the caller can first-touch
+// the storage from the threads that will use it.
+template <class T>
+struct FirstTouchAllocator : std::allocator<T> {
+    template <class U>
+    struct rebind { using other = FirstTouchAllocator<U>; };
+
+    FirstTouchAllocator() noexcept = default;
+    template <class U>
+    FirstTouchAllocator(const FirstTouchAllocator<U>&) noexcept {}
+
+    template <class U>
+    void construct(U* p) noexcept(noexcept(::new (static_cast<void*>(p)) U))
+    {
+        ::new (static_cast<void*>(p)) U;
+    }
+    template <class U, class... Args>
+    void construct(U* p, Args&&... args)
+    {
+        ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+};
+
+template <class T>
+using FirstTouchVector = std::vector<T, FirstTouchAllocator<T>>;
@@ -0,0 +1,133 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <condition_variable>
+#include <cstdio>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "LinearOperatorDouble.hpp"
+#include "SparseSquareMatrixCRSDouble.hpp"
+#include "VectorDouble.hpp"
+
+// Square CRS matrix kept on disk and streamed through memory one row chunk at
+// a time, for operators whose index/value arrays do not fit in RAM. Only x, y
+// and two chunk buffers (kept between calls) are resident.
+//
+// File layout (all fields 64-bit, native endianness):
+//   header   magic, N, nnz, numChunks, index offset
+//   chunks   per chunk: diag[rows], rowPtr[rows + 1] (chunk-local, from 0),
+//            colInd[nnz], val[nnz]
+//   index    per chunk: first row, rows, nnz, file offset
+//
+// apply() double-buffers: while the pool computes chunk k, chunk k + 1 is read
+// by the matrix's prefetch thread, and the kernel is asked to read ahead on
+// k + 2. The header and index are checked against the file size when the
+// matrix is opened, so a truncated or corrupt file throws before anything is
+// allocated from it. Each chunk is checked (row pointers monotone and within the chunk,
+// column indices < N) before it is used; a corrupt chunk throws. The buffers
+// and the prefetch thread belong to the matrix, so concurrent apply() calls
+// on one matrix run one after the other. Needs POSIX file I/O.
+class OutOfCoreSparseMatrixCRSDouble : public LinearOperatorDouble {
+public:
+    // Streams rows to a file in increasing row order; nothing but the
+    // current chunk is held in memory.
+    class Writer {
+    public:
+        // chunks are cut once they reach about chunkBytes on disk
+        Writer(const std::string& path, std::size_t N,
+               std::size_t chunkBytes = std::size_t(64) << 20);
+        ~Writer();
+
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        // append row i (must be the next row; skipped rows stay empty).
+        // An entry with cols[k] == i is added to the diagonal.
+        void addRow(std::size_t i, const std::size_t* cols, const double* vals,
+                    std::size_t count);
+
+        // write the remaining rows and the index; the file is unusable until
+        // this has run
+        void finish();
+
+    private:
+        void flushChunk();
+        void writeBytes(const void* p, std::size_t bytes);
+
+        std::FILE* f_;
+        std::size_t N_;
+        std::size_t chunkBytes_;
+        std::size_t nextRow_;
+        std::size_t nnz_;
+        std::uint64_t offset_;
+        bool finished_;
+
+        // current chunk
+        std::size_t chunkBegin_;
+        std::vector<double> diag_;
+        std::vector<std::uint64_t> rowPtr_;
+        std::vector<std::uint64_t> colInd_;
+        std::vector<double> val_;
+
+        std::vector<std::uint64_t> index_;  // 4 entries per chunk
+    };
+
+    // write a finalized in-memory matrix to path
+    static void write(const std::string& path, const SparseSquareMatrixCRSDouble& A,
+                      std::size_t chunkBytes = std::size_t(64) << 20);
+
+    explicit OutOfCoreSparseMatrixCRSDouble(const std::string& path);
+    ~OutOfCoreSparseMatrixCRSDouble() override;
+
+    OutOfCoreSparseMatrixCRSDouble(const OutOfCoreSparseMatrixCRSDouble&) = delete;
+    OutOfCoreSparseMatrixCRSDouble& operator=(const OutOfCoreSparseMatrixCRSDouble&) = delete;
+
+    std::size_t size() const noexcept override;
+    std::size_t nnz() const noexcept { return nnz_; }
+    std::size_t numChunks() const noexcept { return chunks_.size(); }
+    // largest chunk on disk, i.e. the size of each of the two stream buffers
+    std::size_t maxChunkBytes() const noexcept { return maxChunkBytes_; }
+
+    // y = A * x, streaming the whole file once
+    void apply(const VectorDouble& x, VectorDouble& y) const override;
+
+private:
+    struct Chunk {
+        std::size_t rowBegin;
+        std::size_t rows;
+        std::size_t nnz;
+        std::uint64_t offset;
+        std::size_t bytes;
+    };
+
+    void readChunk(const Chunk& c, char* buf) const;
+    void adviseChunk(const Chunk& c) const;
+    void checkChunk(const Chunk& c, const char* buf) const;
+
+    // prefetch thread: one outstanding read at a time
+    void prefetchLoop();
+    void startRead(const Chunk& c, char* buf) const;
+    void waitRead() const;
+
+    int fd_;
+    std::size_t N_;
+    std::size_t nnz_;
+    std::size_t maxChunkBytes_;
+    std::vector<Chunk> chunks_;
+
+    mutable std::mutex applyM_;               // one apply() at a time
+    mutable std::unique_ptr<char[]> buffers_[2];
+
+    mutable std::mutex readM_;
+    mutable std::condition_variable readCv_;
+    mutable const Chunk* pending_;            // pending request, or null
+    mutable char* pendingBuf_;
+    mutable bool readDone_;
+    mutable std::exception_ptr readError_;
+    bool stopReader_;
+    std::thread reader_;
+};
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+
+// Runtime CPU feature dispatch for the numerical kernels.
+//
+// Every kernel is compiled for SSE2, AVX2 (+FMA) and AVX-512F through GCC/Clang
+// target attributes, so the binary itself only needs the baseline ISA. The
+// best level the CPU supports is picked once, on first use, via CPUID.
+// Setting LA_SIMD_LEVEL=scalar|sse2|avx2|avx512 forces a level; a forced level
+// the CPU cannot run is lowered to the best supported one.
+enum class SimdLevel {
+    Scalar = 0,
+    SSE2,
+    AVX2,
+    AVX512
+};
+
+struct SimdKernels {
+    // out = a + b, out = a - b, out = s * a  (out may alias a or b)
+    void (*add)(const double* a, const double* b, double* out, std::size_t n);
+    void (*sub)(const double* a, const double* b, double* out, std::size_t n);
+    void (*scale)(const double* a, double s, double* out, std::size_t n);
+    // y += alpha * x
+    void (*axpy)(double alpha, const double* x, double* y, std::size_t n);
+    double (*dot)(const double* a, const double* b, std::size_t n);
+    // max |a[i]|, 0 for n == 0; NaN if any a[i] is NaN, at every level
+    double (*maxAbs)(const double* a, std::size_t n);
+    // y = diag .* x + offdiag(CRS) * x for rows [i0, i1), the layout of
+    // SparseSquareMatrixCRSDouble
+    void (*spmvCRS)(std::size_t i0, std::size_t i1, const double* diag,
+                    const std::size_t* rowPtr, const std::size_t* colInd,
+                    const double* val, const double* x, double* y);
+};
+
+// level chosen at startup (CPUID + LA_SIMD_LEVEL)
+SimdLevel simdLevel();
+// best level this CPU supports, ignoring the override
+SimdLevel simdLevelSupported();
+const char* simdLevelName(SimdLevel level);
+
+// kernel table for the selected level
+const SimdKernels& simdKernels();
+// kernel table for an explicit level (lowered to what the CPU supports)
+const SimdKernels& simdKernels(SimdLevel level);
@@ -0,0 +1,144 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "DenseSquareMatrixDouble.hpp"
+#include "SparseSquareMatrixCRSDouble.hpp"
+#include "VectorDouble.hpp"
+#include "MatrixAnalysis.hpp"
+
+// Options and result of one SolveService submission.
+enum class SolveMethod {
+    Auto,       // solver of selectSolverPlan(), as in LinearSystemAuto
+    LU,
+    Cholesky,
+    CG,         // Jacobi-preconditioned
+    GMRES
+};
+
+enum class SolveStatus {
+    Converged,
+    Cancelled,
+    DeadlineExpired
+};
+
+struct SolveOptions {
+    SolveMethod method = SolveMethod::Auto;
+    double relTol = 1e-10;            // iterative methods only
+    std::size_t maxIter = 1000;
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+};
+
+struct SolveResult {
+    SolveStatus status = SolveStatus::Converged;
+    VectorDouble x{0};                // empty unless Converged
+    SolverKind solver = SolverKind::LU;
+    std::size_t iterations = 0;       // 0 for direct solves
+    bool reused = false;              // factors / preconditioner came from the cache
+};
+
+// Asynchronous solver front end: submit A x = b, get a future for x.
+//
+// Scheduling. A job is "large" when its matrix has at least largeWork stored
+// entries (n^2 dense, nnz + n CRS). Large jobs run one at a time on a
+// dedicated thread that owns the ComputePool, so their kernels are
+// parallelised. Small jobs run side by side on the small-job workers, each
+// serially (ComputePool::SerialScope), so they never take the pool from a
+// large job.
+//
+// Auto. The solver comes from selectSolverPlan() on the cached analysis, so
+// a small or dense-enough CRS matrix is factored (as a dense copy) and a
+// large one solved with CG or GMRES. The matrix itself is used in the storage
+// it was submitted in; the plan's BSR format is not applied.
+//
+// Reuse. Matrices are passed as shared_ptr<const ...> and must not change
+// after submission. Everything derived from a matrix (analysis, LU or
+// Cholesky factors, Jacobi preconditioner) is cached per matrix object and
+// reused by later submissions of the same pointer. It is built once even
+// when several jobs for that matrix run at the same time: the first job
+// builds it, the others wait for that build without holding any lock that
+// jobs needing a different object of the entry would take. The cache holds no
+// reference to the matrix; a job does, until it finishes. An entry is freed
+// once its matrix is gone: by the job that held the last reference, before
+// its future becomes ready, or, if the caller drops the matrix later, by the
+// next submit() or cachedMatrices().
+//
+// Cancellation and deadlines. A job cancelled, or past its deadline, before it
+// starts never runs. Once running, iterative solves stop at the next
+// iteration. Direct solves check before every factorization column (row
+// for Cholesky) and before substitution; a factorization abandoned that way is not cached, and
+// the next job for the matrix builds it again.
+// Either way the future holds a result with the corresponding status, not an
+// exception; exceptions are reserved for solver failures, including an
+// iterative solve that does not converge within maxIter. Auto only falls back
+// from CG to GMRES on a CG breakdown.
+class SolveService {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    class Handle {
+    public:
+        Handle() = default;
+
+        // blocks until the job has finished
+        SolveResult get() { return future_.get(); }
+        std::future<SolveResult>& future() { return future_; }
+
+        // request cancellation; a no-op once the job has finished
+        void cancel();
+
+    private:
+        friend class SolveService;
+        std::future<SolveResult> future_;
+        std::shared_ptr<std::atomic<bool>> cancelled_;
+    };
+
+    // smallWorkers == 0 uses std::thread::hardware_concurrency()
+    explicit SolveService(std::size_t smallWorkers = 0,
+                          std::size_t largeWork = std::size_t(1) << 18);
+    // cancels queued jobs and waits for running ones
+    ~SolveService();
+
+    SolveService(const SolveService&) = delete;
+    SolveService& operator=(const SolveService&) = delete;
+
+    Handle submit(std::shared_ptr<const DenseSquareMatrixDouble> A, VectorDouble b,
+                  const SolveOptions& opts = SolveOptions());
+    Handle submit(std::shared_ptr<const SparseSquareMatrixCRSDouble> A, VectorDouble b,
+                  const SolveOptions& opts = SolveOptions());
+
+    // matrices with cache entries; entries of destroyed matrices are freed first
+    std::size_t cachedMatrices();
+    void clearCache();
+
+private:
+    struct MatrixCache;
+    struct Job;
+
+    Handle enqueue(std::unique_ptr<Job> job, std::size_t work);
+    std::shared_ptr<MatrixCache> cacheFor(const std::shared_ptr<const void>& A);
+    void purgeExpired();
+    void workerLoop(bool large);
+    SolveResult run(Job& job);
+
+    std::size_t largeWork_;
+
+    std::mutex m_;
+    std::condition_variable wake_;
+    std::deque<std::unique_ptr<Job>> small_;
+    std::deque<std::unique_ptr<Job>> large_;
+    bool stop_;
+
+    std::mutex cacheM_;
+    std::unordered_map<const void*, std::shared_ptr<MatrixCache>> cache_;
+
+    std::vector<std::thread> workers_;
+};
@@ -0,0 +1,79 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <vector>
+#include "VectorDouble.hpp"
+
+// Block CRS (BSR) square matrix with fixed B x B dense blocks, for multi-DOF
+// problems (elasticity, coupled physics) where every node pair couples through
+// a small dense block. One column index is stored per block, not per scalar.
+//
+// Like SparseSquareMatrixCRSDouble the diagonal is kept apart from the CRS
+// part, here as dense diagonal blocks, whose inverses are formed at finalize()
+// so the matrix doubles as a block-Jacobi preconditioner.
+//
+// Instantiated for B = 2, 3, 4 (see SparseSquareMatrixBSRDouble.cpp).
+template <std::size_t B>
+class SparseSquareMatrixBSRDouble {
+public:
+    static constexpr std::size_t BlockSize = B;
+    static constexpr std::size_t BlockVol = B * B;
+    using Block = std::array<double, B * B>; // row-major
+
+    // Nb = number of block rows/cols; the scalar size is Nb * B
+    explicit SparseSquareMatrixBSRDouble(std::size_t Nb);
+
+    std::size_t size() const noexcept;       // scalar rows
+    std::size_t numBlockRows() const noexcept;
+    std::size_t nnzBlocks() const noexcept;  // off-diagonal blocks
+    std::size_t nnz() const noexcept;        // stored scalars incl. diagonal blocks
+
+    // builder: duplicates are summed, as in SparseSquareMatrixCRSDouble
+    void addEntry(std::size_t i, std::size_t j, double val);
+    void addBlock(std::size_t ib, std::size_t jb, const Block& blk);
+    void finalize();
+
+    // row-parallel over block rows, like the CRS SpMV
+    VectorDouble operator*(const VectorDouble& x) const;
+
+    // z = D^{-1} r with D the block diagonal
+    VectorDouble applyBlockJacobi(const VectorDouble& r) const;
+    bool blockDiagonalInvertible() const noexcept { return diagInvertible_; }
+
+    const std::vector<std::size_t>& rowPtr() const { return rowPtr_; }
+    const std::vector<std::size_t>& colInd() const { return colInd_; }
+    const std::vector<double>& values() const { return val_; }
+    const std::vector<double>& diagonalBlocks() const { return diag_; }
+
+private:
+    struct Triplet {
+        std::size_t i;
+        std::size_t j;
+        double v;
+    };
+    struct BlockTriplet {
+        std::size_t ib;
+        std::size_t jb;
+        Block v;
+    };
+
+    std::size_t Nb_;
+
+    // builder storage: scalar entries stay scalar until finalize() scatters
+    // them into their blocks
+    std::vector<Triplet> entries_;
+    std::vector<BlockTriplet> blockEntries_;
+    bool finalized_;
+
+    // BSR storage, val_ holds B*B doubles per block
+    std::vector<std::size_t> rowPtr_;
+    std::vector<std::size_t> colInd_;
+    std::vector<double> val_;
+    std::vector<double> diag_;
+    std::vector<double> diagInv_;
+    bool diagInvertible_;
+};
+
+extern template class SparseSquareMatrixBSRDouble<2>;
+extern template class SparseSquareMatrixBSRDouble<3>;
+extern template class SparseSquareMatrixBSRDouble<4>;
@@ -4,24 +4,50 @@
 #include <vector>
 #include <utility>
 #include "VectorDouble.hpp"
+#include "DenseSquareMatrixDouble.hpp"
+#include "NumaMemory.hpp"
 
 class SparseSquareMatrixCRSDouble {
 public:
     explicit SparseSquareMatrixCRSDouble(std::size_t N);
 
+    // conversions; fromDense keeps off-diagonal entries with |a| > dropTol
+    // and returns a finalized matrix
+    static SparseSquareMatrixCRSDouble fromDense(const DenseSquareMatrixDouble& A,
+                                                 double dropTol = 0.0);
+    DenseSquareMatrixDouble toDense() const;
+
     std::size_t size() const noexcept;
     std::size_t nnz() const noexcept; 
 
     void addEntry(std::size_t i, std::size_t j, double val);
     void finalize();
 
+    // row-parallel SpMV, split by kRowGrain rows like the vector first touch
     VectorDouble operator*(const VectorDouble& x) const;
+    // y = A * x into an existing vector of size N
+    void multiply(const VectorDouble& x, VectorDouble& y) const;
+
+    // O(nnz + N) structure checks, row-parallel, same semantics as
+    // DenseSquareMatrixDouble; entries missing from the pattern count as zero
+    bool isSymmetric(double absTol = 1e-12, double relTol = 0.0) const;
+    bool isDiagonallyDominant(double relTol = 0.0) const;
 
-    const std::vector<std::size_t>& rowPtr() const { return rowPtr_; }
-    const std::vector<std::size_t>& colInd() const { return colInd_; }
-    const std::vector<double>& values() const { return val_; }
+    bool isFinalized() const noexcept { return finalized_; }
+
+    // raw CRS arrays of a finalized matrix: rowPtr has size() + 1 entries,
+    // colInd and values have nnz()
+    const std::size_t* rowPtrData() const noexcept { return rowPtr_.data(); }
+    const std::size_t* colIndData() const noexcept { return colInd_.data(); }
+    const double* valuesData() const noexcept { return val_.data(); }
     const VectorDouble& diagonal() const { return diag_; }
 
+    // copies of the CRS arrays, source-compatible with the old by-reference
+    // accessors; use the *Data() pointers on hot paths
+    std::vector<std::size_t> rowPtr() const { return {rowPtr_.begin(), rowPtr_.end()}; }
+    std::vector<std::size_t> colInd() const { return {colInd_.begin(), colInd_.end()}; }
+    std::vector<double> values() const { return {val_.begin(), val_.end()}; }
+
 private:
     struct Triplet {
         std::size_t i;
@@ -35,9 +61,10 @@ private:
     std::vector<Triplet> entries_;
     bool finalized_;
 
-    // CRS storage
-    std::vector<std::size_t> rowPtr_;
-    std::vector<std::size_t> colInd_;
-    std::vector<double> val_;
+    // CRS storage; resize() leaves it untouched so the row-parallel fill in
+    // finalize() and fromDense() places each page (see NumaMemory.hpp)
+    FirstTouchVector<std::size_t> rowPtr_;
+    FirstTouchVector<std::size_t> colInd_;
+    FirstTouchVector<double> val_;
     VectorDouble diag_;
 };
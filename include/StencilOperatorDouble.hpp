@@ -0,0 +1,67 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <vector>
+#include "LinearOperatorDouble.hpp"
+
+// Matrix-free stencil operators on an nx x ny x nz structured grid with zero
+// Dirichlet exterior: neighbours outside the grid are dropped. Unknowns are
+// numbered x-fastest, idx = (z * ny + y) * nx + x. Setting nz = 1 gives the 2D
+// operators (the z couplings are never used).
+//
+// apply() sweeps x-rows branch-free, walks z innermost over slabs of y-rows so
+// the three planes it touches stay cached, and spreads the slabs over the
+// ComputePool. No index arrays are stored.
+
+// 7-point (3D) / 5-point (2D) stencil.
+// Coefficient order: center, -x, +x, -y, +y, -z, +z.
+class StencilOperator7Double : public LinearOperatorDouble {
+public:
+    using Coefficients = std::array<double, 7>;
+
+    // constant coefficients
+    StencilOperator7Double(std::size_t nx, std::size_t ny, std::size_t nz,
+                           const Coefficients& c);
+    // variable coefficients, one vector of nx*ny*nz values per stencil entry
+    StencilOperator7Double(std::size_t nx, std::size_t ny, std::size_t nz,
+                           std::array<std::vector<double>, 7>&& c);
+
+    // -Laplacian with grid spacing h (2D when nz == 1)
+    static StencilOperator7Double laplacian(std::size_t nx, std::size_t ny,
+                                            std::size_t nz, double h);
+
+    std::size_t size() const noexcept override;
+    void apply(const VectorDouble& x, VectorDouble& y) const override;
+
+    bool isVariable() const noexcept { return variable_; }
+
+private:
+    std::size_t nx_, ny_, nz_;
+    bool variable_;
+    Coefficients c_;
+    std::array<std::vector<double>, 7> cv_;
+};
+
+// 27-point (3D) / 9-point (2D) stencil.
+// Weight of neighbour (dx, dy, dz) in {-1, 0, 1}^3 sits at
+// (dz + 1) * 9 + (dy + 1) * 3 + (dx + 1).
+class StencilOperator27Double : public LinearOperatorDouble {
+public:
+    using Coefficients = std::array<double, 27>;
+
+    StencilOperator27Double(std::size_t nx, std::size_t ny, std::size_t nz,
+                            const Coefficients& w);
+    StencilOperator27Double(std::size_t nx, std::size_t ny, std::size_t nz,
+                            std::array<std::vector<double>, 27>&& w);
+
+    std::size_t size() const noexcept override;
+    void apply(const VectorDouble& x, VectorDouble& y) const override;
+
+    bool isVariable() const noexcept { return variable_; }
+
+private:
+    std::size_t nx_, ny_, nz_;
+    bool variable_;
+    Coefficients w_;
+    std::array<std::vector<double>, 27> wv_;
+};
@@ -20,11 +20,19 @@ public:
     double& operator[](std::size_t i);
     const double& operator[](std::size_t i) const;
 
+    // raw contiguous storage, for the SIMD kernels
+    double* data() noexcept;
+    const double* data() const noexcept;
+
     // algebra
     VectorDouble operator+(const VectorDouble& other) const;
     VectorDouble operator-(const VectorDouble& other) const;
     VectorDouble operator*(double scalar) const;
 
+    // in-place BLAS-1 helpers for the iterative solvers
+    double dot(const VectorDouble& other) const;
+    void axpy(double alpha, const VectorDouble& x); // this += alpha * x
+
     // norms
     double norm_n(int n) const;
     double normInf() const;
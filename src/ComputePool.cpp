@@ -0,0 +1,249 @@
+#include "ComputePool.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace {
+
+thread_local bool tInsidePool = false;
+
+std::size_t threadsFromEnv()
+{
+    if (const char* env = std::getenv("LA_NUM_THREADS")) {
+        const long v = std::strtol(env, nullptr, 10);
+        if (v > 0)
+            return static_cast<std::size_t>(v);
+    }
+    const unsigned hw = std::thread::hardware_concurrency();
+    return hw > 0 ? hw : 1;
+}
+
+// one CPU per thread from LA_PIN_THREADS, empty when unset or unsupported
+std::vector<int> pinCpusFromEnv(std::size_t nthreads)
+{
+    std::vector<int> cpus;
+#ifdef __linux__
+    const char* env = std::getenv("LA_PIN_THREADS");
+    if (!env || !*env)
+        return cpus;
+
+    std::vector<int> avail;
+    if (std::string(env) == "compact") {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) != 0)
+            return cpus;
+        for (int c = 0; c < CPU_SETSIZE; ++c)
+            if (CPU_ISSET(c, &set))
+                avail.push_back(c);
+    } else {
+        const char* p = env;
+        while (*p) {
+            char* end = nullptr;
+            const long c = std::strtol(p, &end, 10);
+            if (end == p || c < 0 || c >= CPU_SETSIZE)
+                return cpus;
+            avail.push_back(static_cast<int>(c));
+            p = (*end == ',') ? end + 1 : end;
+            if (*end != ',' && *end != '\0')
+                return cpus;
+        }
+    }
+    if (avail.empty())
+        return cpus;
+
+    for (std::size_t t = 0; t < nthreads; ++t)
+        cpus.push_back(avail[t % avail.size()]);
+#else
+    (void)nthreads;
+#endif
+    return cpus;
+}
+
+void pinCurrentThread(int cpu)
+{
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+#else
+    (void)cpu;
+#endif
+}
+
+// pins the calling thread to `cpu` (< 0: no-op) and restores its previous
+// affinity on destruction
+class ScopedPin {
+public:
+    explicit ScopedPin(int cpu)
+    {
+#ifdef __linux__
+        CPU_ZERO(&saved_);
+        active_ = cpu >= 0 && sched_getaffinity(0, sizeof(saved_), &saved_) == 0;
+        if (active_)
+            pinCurrentThread(cpu);
+#else
+        (void)cpu;
+#endif
+    }
+    ~ScopedPin()
+    {
+#ifdef __linux__
+        if (active_)
+            sched_setaffinity(0, sizeof(saved_), &saved_);
+#endif
+    }
+    ScopedPin(const ScopedPin&) = delete;
+    ScopedPin& operator=(const ScopedPin&) = delete;
+
+private:
+#ifdef __linux__
+    cpu_set_t saved_;
+    bool active_;
+#endif
+};
+
+} // namespace
+
+ComputePool& ComputePool::instance()
+{
+    static ComputePool pool(threadsFromEnv());
+    return pool;
+}
+
+ComputePool::ComputePool(std::size_t nthreads)
+    : cpus_(pinCpusFromEnv(nthreads)),
+      generation_(0), pending_(0), stop_(false), body_(nullptr), n_(0), chunks_(0)
+{
+    for (std::size_t t = 1; t < nthreads; ++t)
+        workers_.emplace_back(&ComputePool::workerLoop, this, t);
+}
+
+ComputePool::~ComputePool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& w : workers_)
+        w.join();
+}
+
+std::size_t ComputePool::numThreads() const noexcept
+{
+    return workers_.size() + 1;
+}
+
+std::size_t ComputePool::chunkBegin(std::size_t n, std::size_t chunks, std::size_t t)
+{
+    return n / chunks * t + std::min(t, n % chunks);
+}
+
+ComputePool::SerialScope::SerialScope()
+    : prev_(tInsidePool)
+{
+    tInsidePool = true;
+}
+
+ComputePool::SerialScope::~SerialScope()
+{
+    tInsidePool = prev_;
+}
+
+void ComputePool::runChunk(std::size_t tid)
+{
+    const std::size_t begin = chunkBegin(n_, chunks_, tid);
+    const std::size_t end = chunkBegin(n_, chunks_, tid + 1);
+
+    try {
+        (*body_)(begin, end);
+    }
+    catch (...) {
+        std::lock_guard<std::mutex> lock(m_);
+        if (!error_)
+            error_ = std::current_exception();
+    }
+}
+
+void ComputePool::workerLoop(std::size_t tid)
+{
+    tInsidePool = true;
+    if (!cpus_.empty())
+        pinCurrentThread(cpus_[tid]);
+    std::size_t seen = 0;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_);
+            wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_)
+                return;
+            seen = generation_;
+            if (tid >= chunks_)
+                continue;
+        }
+
+        runChunk(tid);
+
+        std::lock_guard<std::mutex> lock(m_);
+        if (--pending_ == 0)
+            done_.notify_one();
+    }
+}
+
+void ComputePool::parallelFor(std::size_t n, std::size_t grain, const Body& body)
+{
+    if (n == 0)
+        return;
+
+    grain = std::max<std::size_t>(grain, 1);
+    const std::size_t chunks = std::min(numThreads(), (n + grain - 1) / grain);
+
+    std::unique_lock<std::mutex> owner(submit_, std::defer_lock);
+    if (chunks <= 1 || tInsidePool || !owner.try_lock()) {
+        body(0, n);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        body_ = &body;
+        n_ = n;
+        chunks_ = chunks;
+        pending_ = chunks - 1;
+        error_ = nullptr;
+        ++generation_;
+    }
+    wake_.notify_all();
+
+    {
+        // the caller is thread 0, pinned only while it runs its chunk
+        ScopedPin pin(cpus_.empty() ? -1 : cpus_[0]);
+        tInsidePool = true;
+        runChunk(0);
+        tInsidePool = false;
+    }
+
+    std::exception_ptr err;
+    {
+        std::unique_lock<std::mutex> lock(m_);
+        done_.wait(lock, [&] { return pending_ == 0; });
+        err = error_;
+        error_ = nullptr;
+        body_ = nullptr;
+    }
+
+    if (err)
+        std::rethrow_exception(err);
+}
+
+void parallelFor(std::size_t n, std::size_t grain, const ComputePool::Body& body)
+{
+    ComputePool::instance().parallelFor(n, grain, body);
+}
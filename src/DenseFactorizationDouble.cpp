@@ -0,0 +1,134 @@
+#include "DenseFactorizationDouble.hpp"
+#include "SimdDispatch.hpp"
+#include "ComputePool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+DenseLUDouble::DenseLUDouble(const DenseSquareMatrixDouble& A, const FactorizationStop& stop)
+    : LU_(A), perm_(A.size())
+{
+    const std::size_t N = LU_.size();
+    double* a = LU_.data();
+    const SimdKernels& k = simdKernels();
+
+    for (std::size_t i = 0; i < N; ++i)
+        perm_[i] = i;
+
+    for (std::size_t c = 0; c < N; ++c) {
+        if (stop && stop())
+            throw FactorizationStopped();
+
+        std::size_t piv = c;
+        double best = std::abs(a[c * N + c]);
+        for (std::size_t r = c + 1; r < N; ++r) {
+            const double v = std::abs(a[r * N + c]);
+            if (v > best) {
+                best = v;
+                piv = r;
+            }
+        }
+        if (best == 0.0)
+            throw std::runtime_error("Error: Singular matrix in DenseLUDouble");
+
+        if (piv != c) {
+            std::swap_ranges(a + c * N, a + (c + 1) * N, a + piv * N);
+            std::swap(perm_[c], perm_[piv]);
+        }
+
+        // right-looking update, rows are contiguous so each one is an axpy
+        const double inv = 1.0 / a[c * N + c];
+        const double* urow = a + c * N + c + 1;
+        const std::size_t len = N - c - 1;
+
+        parallelFor(N - c - 1, 64, [&](std::size_t r0, std::size_t r1) {
+            for (std::size_t r = c + 1 + r0; r < c + 1 + r1; ++r) {
+                const double f = a[r * N + c] * inv;
+                a[r * N + c] = f;
+                k.axpy(-f, urow, a + r * N + c + 1, len);
+            }
+        });
+    }
+}
+
+std::size_t DenseLUDouble::size() const noexcept
+{
+    return LU_.size();
+}
+
+VectorDouble DenseLUDouble::solve(const VectorDouble& b) const
+{
+    const std::size_t N = LU_.size();
+    if (b.size() != N)
+        throw std::runtime_error("Error: Dimension mismatch in DenseLUDouble::solve");
+
+    const double* a = LU_.data();
+    const SimdKernels& k = simdKernels();
+
+    // L y = P b
+    VectorDouble x(N);
+    for (std::size_t i = 0; i < N; ++i)
+        x[i] = b[perm_[i]] - k.dot(a + i * N, x.data(), i);
+
+    // U x = y
+    for (std::size_t i = N; i-- > 0;)
+        x[i] = (x[i] - k.dot(a + i * N + i + 1, x.data() + i + 1, N - i - 1)) / a[i * N + i];
+
+    return x;
+}
+
+DenseCholeskyDouble::DenseCholeskyDouble(const DenseSquareMatrixDouble& A,
+                                         const FactorizationStop& stop)
+    : L_(A.size())
+{
+    const std::size_t N = A.size();
+    double* l = L_.data();
+    const SimdKernels& k = simdKernels();
+
+    // row-oriented Cholesky-Crout: L(i, j) needs rows i and j up to column j,
+    // both contiguous
+    for (std::size_t i = 0; i < N; ++i) {
+        if (stop && stop())
+            throw FactorizationStopped();
+
+        double* li = l + i * N;
+        for (std::size_t j = 0; j < i; ++j) {
+            const double* lj = l + j * N;
+            li[j] = (A(i, j) - k.dot(li, lj, j)) / lj[j];
+        }
+
+        const double d = A(i, i) - k.dot(li, li, i);
+        if (!(d > 0.0))
+            throw std::runtime_error("Error: Matrix not positive definite in DenseCholeskyDouble");
+        li[i] = std::sqrt(d);
+    }
+}
+
+std::size_t DenseCholeskyDouble::size() const noexcept
+{
+    return L_.size();
+}
+
+VectorDouble DenseCholeskyDouble::solve(const VectorDouble& b) const
+{
+    const std::size_t N = L_.size();
+    if (b.size() != N)
+        throw std::runtime_error("Error: Dimension mismatch in DenseCholeskyDouble::solve");
+
+    const double* l = L_.data();
+    const SimdKernels& k = simdKernels();
+
+    // L y = b
+    VectorDouble x(N);
+    for (std::size_t i = 0; i < N; ++i)
+        x[i] = (b[i] - k.dot(l + i * N, x.data(), i)) / l[i * N + i];
+
+    // L^T x = y, column sweep so L is still read by rows
+    for (std::size_t i = N; i-- > 0;) {
+        x[i] /= l[i * N + i];
+        k.axpy(-x[i], l + i * N, x.data(), i);
+    }
+
+    return x;
+}
@@ -1,19 +1,24 @@
 #include "DenseSquareMatrixDouble.hpp"
+#include "SimdDispatch.hpp"
+#include "ComputePool.hpp"
+#include "NumaMemory.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <stdexcept>
 #include <utility>
 
+// rows are first-touched with the partition of the row-parallel kernels
 DenseSquareMatrixDouble::DenseSquareMatrixDouble(std::size_t N)
-    : N_(N), data_(std::make_unique<double[]>(N * N))
+    : N_(N), data_(new double[N * N])
 {
-    for (std::size_t i = 0; i < N_ * N_; ++i)
-        data_[i] = 0.0;
+    firstTouchFillRows(data_.get(), N_, N_, 0.0);
 }
 
 DenseSquareMatrixDouble::DenseSquareMatrixDouble(const DenseSquareMatrixDouble& other)
-    : N_(other.N_), data_(std::make_unique<double[]>(other.N_ * other.N_))
+    : N_(other.N_), data_(new double[other.N_ * other.N_])
 {
-    for (std::size_t i = 0; i < N_ * N_; ++i)
-        data_[i] = other.data_[i];
+    firstTouchCopyRows(data_.get(), other.data_.get(), N_, N_);
 }
 
 DenseSquareMatrixDouble&
@@ -24,11 +29,10 @@ DenseSquareMatrixDouble::operator=(const DenseSquareMatrixDouble& other)
 
     if (N_ != other.N_) {
         N_ = other.N_;
-        data_ = std::make_unique<double[]>(N_ * N_);
+        data_.reset(new double[N_ * N_]);
     }
 
-    for (std::size_t i = 0; i < N_ * N_; ++i)
-        data_[i] = other.data_[i];
+    firstTouchCopyRows(data_.get(), other.data_.get(), N_, N_);
 
     return *this;
 }
@@ -67,6 +71,16 @@ const double& DenseSquareMatrixDouble::operator()(std::size_t i, std::size_t j)
     return data_[i * N_ + j];
 }
 
+double* DenseSquareMatrixDouble::data() noexcept
+{
+    return data_.get();
+}
+
+const double* DenseSquareMatrixDouble::data() const noexcept
+{
+    return data_.get();
+}
+
 DenseSquareMatrixDouble
 DenseSquareMatrixDouble::operator+(const DenseSquareMatrixDouble& other) const
 {
@@ -75,8 +89,7 @@ DenseSquareMatrixDouble::operator+(const DenseSquareMatrixDouble& other) const
 
     DenseSquareMatrixDouble result(N_);
 
-    for (std::size_t i = 0; i < N_ * N_; ++i)
-        result.data_[i] = data_[i] + other.data_[i];
+    simdKernels().add(data_.get(), other.data_.get(), result.data_.get(), N_ * N_);
 
     return result;
 }
@@ -89,8 +102,7 @@ DenseSquareMatrixDouble::operator-(const DenseSquareMatrixDouble& other) const
 
     DenseSquareMatrixDouble result(N_);
 
-    for (std::size_t i = 0; i < N_ * N_; ++i)
-        result.data_[i] = data_[i] - other.data_[i];
+    simdKernels().sub(data_.get(), other.data_.get(), result.data_.get(), N_ * N_);
 
     return result;
 }
@@ -101,19 +113,21 @@ DenseSquareMatrixDouble::operator*(const DenseSquareMatrixDouble& other) const
     if (N_ != other.N_)
         throw std::runtime_error("Error: Matrix dimention mismatch (*)");
 
+    const SimdKernels& k = simdKernels();
+
     DenseSquareMatrixDouble result(N_);
-    for (std::size_t i = 0; i < N_; ++i)
-    {
-        for (std::size_t k = 0; k < N_; ++k)
+    parallelFor(N_, kRowGrain, [&](std::size_t i0, std::size_t i1) {
+        for (std::size_t i = i0; i < i1; ++i)
         {
-            double aik = (*this)(i, k);
+            double* ci = result.data_.get() + i * N_;
 
-            for (std::size_t j = 0; j < N_; ++j)
+            for (std::size_t kk = 0; kk < N_; ++kk)
             {
-                result(i, j) += aik * other(k, j);
+                // C(i, :) += A(i, k) * B(k, :)
+                k.axpy((*this)(i, kk), other.data_.get() + kk * N_, ci, N_);
             }
         }
-    }
+    });
 
     return result;
 }
@@ -124,8 +138,7 @@ DenseSquareMatrixDouble::operator*(double scalar) const
 {
     DenseSquareMatrixDouble result(N_);
 
-    for (std::size_t i = 0; i < N_ * N_; ++i)
-        result.data_[i] = data_[i] * scalar;
+    simdKernels().scale(data_.get(), scalar, result.data_.get(), N_ * N_);
 
     return result;
 }
@@ -136,19 +149,105 @@ DenseSquareMatrixDouble::operator*(const VectorDouble& x) const
     if (x.size() != N_)
         throw std::runtime_error("Error: Matrix-vector dimention mismatch (*)");
 
-    VectorDouble result(N_);
+    const SimdKernels& k = simdKernels();
 
-    for (std::size_t i = 0; i < N_; ++i)
-    {
-        double sum = 0.0;
+    VectorDouble result(N_);
 
-        for (std::size_t j = 0; j < N_; ++j)
+    parallelFor(N_, kRowGrain, [&](std::size_t i0, std::size_t i1) {
+        for (std::size_t i = i0; i < i1; ++i)
         {
-            sum += (*this)(i, j) * x[j];
+            result[i] = k.dot(data_.get() + i * N_, x.data(), N_);
         }
-
-        result[i] = sum;
-    }
+    });
 
     return result;
 }
+
+namespace {
+
+// square tiles compared against their transposed partner; two 32x32 tiles
+// of doubles (16 KiB) stay in L1 while one is read by rows, the other by columns
+constexpr std::size_t kSymTile = 32;
+
+inline bool entriesMatch(double a, double b, double absTol, double relTol)
+{
+    const double tol = std::max(absTol, relTol * std::max(std::abs(a), std::abs(b)));
+    return std::abs(a - b) <= tol;
+}
+
+} // namespace
+
+bool DenseSquareMatrixDouble::isSymmetric(double absTol, double relTol) const
+{
+    const std::size_t nb = (N_ + kSymTile - 1) / kSymTile;
+    const double* a = data_.get();
+    std::atomic<bool> symmetric(true);
+
+    // tile (bi, bj) with bj >= bi against tile (bj, bi)
+    auto checkTilePair = [&](std::size_t bi, std::size_t bj) {
+        const std::size_t i0 = bi * kSymTile, i1 = std::min(i0 + kSymTile, N_);
+        const std::size_t j0 = bj * kSymTile, j1 = std::min(j0 + kSymTile, N_);
+
+        for (std::size_t i = i0; i < i1; ++i) {
+            const std::size_t jStart = (bi == bj) ? i + 1 : j0;
+            for (std::size_t j = jStart; j < j1; ++j) {
+                if (!entriesMatch(a[i * N_ + j], a[j * N_ + i], absTol, relTol))
+                    return false;
+            }
+        }
+        return true;
+    };
+
+    // block row bi carries nb - bi tiles; pairing bi with nb - 1 - bi
+    // gives every work unit nb + 1 tiles
+    const std::size_t units = (nb + 1) / 2;
+
+    parallelFor(units, 1, [&](std::size_t u0, std::size_t u1) {
+        for (std::size_t u = u0; u < u1; ++u) {
+            const std::size_t rows[2] = {u, nb - 1 - u};
+            const std::size_t nrows = (rows[0] == rows[1]) ? 1 : 2;
+
+            for (std::size_t r = 0; r < nrows; ++r) {
+                const std::size_t bi = rows[r];
+                for (std::size_t bj = bi; bj < nb; ++bj) {
+                    if (!symmetric.load(std::memory_order_relaxed))
+                        return;
+                    if (!checkTilePair(bi, bj)) {
+                        symmetric.store(false, std::memory_order_relaxed);
+                        return;
+                    }
+                }
+            }
+        }
+    });
+
+    return symmetric.load();
+}
+
+bool DenseSquareMatrixDouble::isDiagonallyDominant(double relTol) const
+{
+    const double* a = data_.get();
+    std::atomic<bool> dominant(true);
+
+    parallelFor(N_, 64, [&](std::size_t i0, std::size_t i1) {
+        for (std::size_t i = i0; i < i1; ++i) {
+            if (!dominant.load(std::memory_order_relaxed))
+                return;
+
+            const double* row = a + i * N_;
+            double off_sum = 0.0;
+            for (std::size_t j = 0; j < i; ++j)
+                off_sum += std::abs(row[j]);
+            for (std::size_t j = i + 1; j < N_; ++j)
+                off_sum += std::abs(row[j]);
+            const double diag = std::abs(row[i]);
+
+            if (diag < (1.0 - relTol) * off_sum) {
+                dominant.store(false, std::memory_order_relaxed);
+                return;
+            }
+        }
+    });
+
+    return dominant.load();
+}
@@ -0,0 +1,226 @@
+#ifdef LA_WITH_MPI
+
+#include "DistributedSparseMatrixCRSDouble.hpp"
+#include "ComputePool.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+DistributedSparseMatrixCRSDouble::DistributedSparseMatrixCRSDouble(MPI_Comm comm, std::size_t globalN)
+    : comm_(comm), N_(globalN), rank_(0), nprocs_(1), r0_(0), r1_(0), finalized_(false)
+{
+    MPI_Comm_rank(comm_, &rank_);
+    MPI_Comm_size(comm_, &nprocs_);
+    r0_ = DistributedVectorDouble::rowBegin(N_, nprocs_, rank_);
+    r1_ = DistributedVectorDouble::rowBegin(N_, nprocs_, rank_ + 1);
+}
+
+void DistributedSparseMatrixCRSDouble::addEntry(std::size_t i, std::size_t j, double val)
+{
+    if (finalized_)
+        throw std::runtime_error("Error: Cannot addEntry after finalize()");
+    if (i < r0_ || i >= r1_ || j >= N_)
+        throw std::runtime_error("Error: addEntry row not owned by this rank or index out of range");
+
+    entries_.push_back({i - r0_, j, val});
+}
+
+void DistributedSparseMatrixCRSDouble::finalize()
+{
+    if (finalized_)
+        return;
+
+    const std::size_t nLocal = r1_ - r0_;
+
+    std::sort(entries_.begin(), entries_.end(),
+              [](const Triplet& a, const Triplet& b) {
+                  if (a.i != b.i) {
+                    return a.i < b.i;
+                  }
+                  return a.j < b.j;
+              });
+
+    // merge duplicates in place
+    std::size_t w = 0;
+    for (std::size_t k = 0; k < entries_.size(); ++k) {
+        if (w > 0 && entries_[w - 1].i == entries_[k].i && entries_[w - 1].j == entries_[k].j)
+            entries_[w - 1].v += entries_[k].v;
+        else
+            entries_[w++] = entries_[k];
+    }
+    entries_.resize(w);
+
+    // ghost columns, sorted and unique
+    ghostGlobal_.clear();
+    for (const Triplet& t : entries_)
+        if (t.j < r0_ || t.j >= r1_)
+            ghostGlobal_.push_back(t.j);
+    std::sort(ghostGlobal_.begin(), ghostGlobal_.end());
+    ghostGlobal_.erase(std::unique(ghostGlobal_.begin(), ghostGlobal_.end()), ghostGlobal_.end());
+
+    // local CRS with the diagonal kept apart, as in SparseSquareMatrixCRSDouble
+    diag_.assign(nLocal, 0.0);
+    rowPtr_.assign(nLocal + 1, 0);
+    colInd_.clear();
+    val_.clear();
+    std::vector<char> hasGhost(nLocal, 0);
+
+    for (const Triplet& t : entries_) {
+        if (t.j == t.i + r0_) {
+            diag_[t.i] += t.v;
+            continue;
+        }
+
+        std::size_t col;
+        if (t.j >= r0_ && t.j < r1_) {
+            col = t.j - r0_;
+        } else {
+            col = nLocal + static_cast<std::size_t>(
+                std::lower_bound(ghostGlobal_.begin(), ghostGlobal_.end(), t.j) - ghostGlobal_.begin());
+            hasGhost[t.i] = 1;
+        }
+        rowPtr_[t.i + 1] += 1;
+        colInd_.push_back(col);
+        val_.push_back(t.v);
+    }
+    for (std::size_t i = 0; i < nLocal; ++i)
+        rowPtr_[i + 1] += rowPtr_[i];
+
+    interiorRows_.clear();
+    boundaryRows_.clear();
+    for (std::size_t i = 0; i < nLocal; ++i)
+        (hasGhost[i] ? boundaryRows_ : interiorRows_).push_back(i);
+
+    // how many ghosts each rank owns; ghosts are sorted so owners are monotone
+    const std::size_t P = static_cast<std::size_t>(nprocs_);
+    std::vector<int> recvCounts(P, 0);
+    {
+        int owner = 0;
+        for (std::size_t g : ghostGlobal_) {
+            while (g >= DistributedVectorDouble::rowBegin(N_, nprocs_, owner + 1))
+                ++owner;
+            recvCounts[static_cast<std::size_t>(owner)] += 1;
+        }
+    }
+
+    std::vector<int> sendCounts(P, 0);
+    MPI_Alltoall(recvCounts.data(), 1, MPI_INT, sendCounts.data(), 1, MPI_INT, comm_);
+
+    std::vector<int> rdispl(P + 1, 0), sdispl(P + 1, 0);
+    for (std::size_t r = 0; r < P; ++r) {
+        rdispl[r + 1] = rdispl[r] + recvCounts[r];
+        sdispl[r + 1] = sdispl[r] + sendCounts[r];
+    }
+
+    // tell every owner which of its rows we need
+    std::vector<std::uint64_t> want(ghostGlobal_.begin(), ghostGlobal_.end());
+    std::vector<std::uint64_t> asked(static_cast<std::size_t>(sdispl[P]));
+    MPI_Alltoallv(want.data(), recvCounts.data(), rdispl.data(), MPI_UINT64_T,
+                  asked.data(), sendCounts.data(), sdispl.data(), MPI_UINT64_T, comm_);
+
+    recvRanks_.clear();
+    recvOffsets_.assign(1, 0);
+    sendRanks_.clear();
+    sendOffsets_.assign(1, 0);
+    for (std::size_t r = 0; r < P; ++r) {
+        if (recvCounts[r] > 0) {
+            recvRanks_.push_back(static_cast<int>(r));
+            recvOffsets_.push_back(static_cast<std::size_t>(rdispl[r + 1]));
+        }
+        if (sendCounts[r] > 0) {
+            sendRanks_.push_back(static_cast<int>(r));
+            sendOffsets_.push_back(static_cast<std::size_t>(sdispl[r + 1]));
+        }
+    }
+
+    sendIdx_.resize(asked.size());
+    for (std::size_t k = 0; k < asked.size(); ++k)
+        sendIdx_[k] = static_cast<std::size_t>(asked[k]) - r0_;
+
+    xExt_.assign(nLocal + ghostGlobal_.size(), 0.0);
+    sendBuf_.assign(sendIdx_.size(), 0.0);
+
+    finalized_ = true;
+
+    entries_.clear();
+    entries_.shrink_to_fit();
+}
+
+void DistributedSparseMatrixCRSDouble::checkVector(const DistributedVectorDouble& v) const
+{
+    if (v.globalSize() != N_ || v.rowBegin() != r0_ || v.rowEnd() != r1_)
+        throw std::runtime_error("Error: Distributed partition mismatch in A*x");
+}
+
+void DistributedSparseMatrixCRSDouble::multiplyRows(const std::vector<std::size_t>& rows,
+                                                    const double* xExt, double* y) const
+{
+    parallelFor(rows.size(), 256, [&](std::size_t k0, std::size_t k1) {
+        for (std::size_t k = k0; k < k1; ++k) {
+            const std::size_t i = rows[k];
+            double sum = diag_[i] * xExt[i];
+            for (std::size_t p = rowPtr_[i]; p < rowPtr_[i + 1]; ++p)
+                sum += val_[p] * xExt[colInd_[p]];
+            y[i] = sum;
+        }
+    });
+}
+
+void DistributedSparseMatrixCRSDouble::multiply(const DistributedVectorDouble& x,
+                                                DistributedVectorDouble& y) const
+{
+    checkVector(x);
+    checkVector(y);
+    multiplyLocal(x.local(), y.local());
+}
+
+void DistributedSparseMatrixCRSDouble::multiplyLocal(const VectorDouble& x, VectorDouble& y) const
+{
+    if (!finalized_)
+        throw std::runtime_error("Error: DistributedSparseMatrixCRSDouble not finalized()");
+
+    const std::size_t nLocal = r1_ - r0_;
+    if (x.size() != nLocal || y.size() != nLocal)
+        throw std::runtime_error("Error: Distributed partition mismatch in A*x");
+    const double* xl = x.data();
+    const int tag = 7301;
+
+    std::vector<MPI_Request> reqs;
+    reqs.reserve(recvRanks_.size() + sendRanks_.size());
+
+    // ghosts go straight behind the owned values in xExt_
+    for (std::size_t k = 0; k < recvRanks_.size(); ++k) {
+        reqs.emplace_back();
+        MPI_Irecv(xExt_.data() + nLocal + recvOffsets_[k],
+                  static_cast<int>(recvOffsets_[k + 1] - recvOffsets_[k]), MPI_DOUBLE,
+                  recvRanks_[k], tag, comm_, &reqs.back());
+    }
+
+    for (std::size_t k = 0; k < sendIdx_.size(); ++k)
+        sendBuf_[k] = xl[sendIdx_[k]];
+    for (std::size_t k = 0; k < sendRanks_.size(); ++k) {
+        reqs.emplace_back();
+        MPI_Isend(sendBuf_.data() + sendOffsets_[k],
+                  static_cast<int>(sendOffsets_[k + 1] - sendOffsets_[k]), MPI_DOUBLE,
+                  sendRanks_[k], tag, comm_, &reqs.back());
+    }
+
+    std::copy(xl, xl + nLocal, xExt_.begin());
+
+    // overlap: interior rows only touch owned columns
+    double* yl = y.data();
+    multiplyRows(interiorRows_, xExt_.data(), yl);
+
+    MPI_Waitall(static_cast<int>(reqs.size()), reqs.data(), MPI_STATUSES_IGNORE);
+
+    multiplyRows(boundaryRows_, xExt_.data(), yl);
+}
+
+DistributedVectorDouble DistributedSparseMatrixCRSDouble::operator*(const DistributedVectorDouble& x) const
+{
+    DistributedVectorDouble y(comm_, N_);
+    multiply(x, y);
+    return y;
+}
+
+#endif // LA_WITH_MPI
@@ -0,0 +1,96 @@
+#ifdef LA_WITH_MPI
+
+#include "DistributedVectorDouble.hpp"
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+int commSize(MPI_Comm comm)
+{
+    int P = 1;
+    MPI_Comm_size(comm, &P);
+    return P;
+}
+
+int commRank(MPI_Comm comm)
+{
+    int r = 0;
+    MPI_Comm_rank(comm, &r);
+    return r;
+}
+
+} // namespace
+
+std::size_t DistributedVectorDouble::rowBegin(std::size_t N, int P, int r)
+{
+    const std::size_t p = static_cast<std::size_t>(P);
+    const std::size_t t = static_cast<std::size_t>(r);
+    return N / p * t + (t < N % p ? t : N % p);
+}
+
+DistributedVectorDouble::DistributedVectorDouble(MPI_Comm comm, std::size_t globalSize)
+    : comm_(comm), N_(globalSize),
+      r0_(rowBegin(globalSize, commSize(comm), commRank(comm))),
+      local_(rowBegin(globalSize, commSize(comm), commRank(comm) + 1) - r0_)
+{}
+
+DistributedVectorDouble::DistributedVectorDouble(MPI_Comm comm, std::size_t N, std::size_t r0,
+                                                 VectorDouble&& local)
+    : comm_(comm), N_(N), r0_(r0), local_(std::move(local))
+{}
+
+void DistributedVectorDouble::checkCompatible(const DistributedVectorDouble& other) const
+{
+    if (N_ != other.N_ || r0_ != other.r0_ || local_.size() != other.local_.size())
+        throw std::runtime_error("Error: Distributed vector partition mismatch");
+}
+
+DistributedVectorDouble DistributedVectorDouble::operator+(const DistributedVectorDouble& other) const
+{
+    checkCompatible(other);
+    return DistributedVectorDouble(comm_, N_, r0_, local_ + other.local_);
+}
+
+DistributedVectorDouble DistributedVectorDouble::operator-(const DistributedVectorDouble& other) const
+{
+    checkCompatible(other);
+    return DistributedVectorDouble(comm_, N_, r0_, local_ - other.local_);
+}
+
+DistributedVectorDouble DistributedVectorDouble::operator*(double scalar) const
+{
+    return DistributedVectorDouble(comm_, N_, r0_, local_ * scalar);
+}
+
+void DistributedVectorDouble::axpy(double alpha, const DistributedVectorDouble& x)
+{
+    checkCompatible(x);
+    local_.axpy(alpha, x.local_);
+}
+
+double DistributedVectorDouble::dot(const DistributedVectorDouble& other) const
+{
+    checkCompatible(other);
+
+    double local = local_.dot(other.local_);
+    double global = 0.0;
+    MPI_Allreduce(&local, &global, 1, MPI_DOUBLE, MPI_SUM, comm_);
+    return global;
+}
+
+double DistributedVectorDouble::norm2() const
+{
+    return std::sqrt(dot(*this));
+}
+
+double DistributedVectorDouble::normInf() const
+{
+    double local = local_.normInf();
+    double global = 0.0;
+    MPI_Allreduce(&local, &global, 1, MPI_DOUBLE, MPI_MAX, comm_);
+    return global;
+}
+
+#endif // LA_WITH_MPI
@@ -0,0 +1,179 @@
+#include "KrylovSolvers.hpp"
+#include "SimdDispatch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+void checkDims(const LinearOperatorDouble& A, const VectorDouble& b, const VectorDouble& x)
+{
+    if (b.size() != A.size() || x.size() != A.size())
+        throw std::runtime_error("Error: Dimension mismatch in Krylov solver");
+}
+
+// the caller's inner product, or the local one
+double innerProduct(const KrylovDot& dot, const VectorDouble& a, const VectorDouble& b)
+{
+    return dot ? dot(a, b) : a.dot(b);
+}
+
+// CG, preconditioned when M is set (z = M r), plain otherwise (z = r)
+std::size_t cgLoop(const LinearOperatorDouble& A, const LinearOperatorDouble* M,
+                   const VectorDouble& b, VectorDouble& x, double relTol,
+                   std::size_t maxIter, const KrylovStop& stop, const KrylovDot& dot)
+{
+    checkDims(A, b, x);
+    if (M && M->size() != A.size())
+        throw std::runtime_error("Error: Dimension mismatch in Krylov solver");
+
+    const double bnorm = std::sqrt(innerProduct(dot, b, b));
+    const double target = relTol * (bnorm > 0.0 ? bnorm : 1.0);
+
+    VectorDouble r = b - (A * x);
+    VectorDouble z(M ? x.size() : 0);
+    if (M)
+        M->apply(r, z);
+    const VectorDouble& zr = M ? z : r;
+    VectorDouble p = zr;
+    VectorDouble Ap(x.size());
+    double rz = innerProduct(dot, r, zr);
+    double rr = M ? innerProduct(dot, r, r) : rz;
+
+    for (std::size_t it = 0; it < maxIter; ++it) {
+        if (std::sqrt(rr) <= target)
+            return it;
+        if (stop && stop())
+            throw KrylovStopped();
+
+        A.apply(p, Ap);
+        const double pAp = innerProduct(dot, p, Ap);
+        if (!(pAp > 0.0))
+            throw KrylovBreakdown("Error: CG breakdown, operator is not SPD");
+
+        const double alpha = rz / pAp;
+        x.axpy(alpha, p);
+        r.axpy(-alpha, Ap);
+
+        if (M) {
+            rr = innerProduct(dot, r, r);
+            M->apply(r, z);
+        }
+        const double rzNew = innerProduct(dot, r, zr);
+        const double beta = rzNew / rz;
+        rz = rzNew;
+        if (!M)
+            rr = rz;
+
+        // p = z + beta * p, in place
+        simdKernels().scale(p.data(), beta, p.data(), p.size());
+        p.axpy(1.0, zr);
+    }
+
+    if (std::sqrt(rr) <= target)
+        return maxIter;
+    throw std::runtime_error("Error: CG did not converge within maxIter");
+}
+
+} // namespace
+
+std::size_t solveCG(const LinearOperatorDouble& A, const VectorDouble& b, VectorDouble& x,
+                    double relTol, std::size_t maxIter, const KrylovStop& stop,
+                    const KrylovDot& dot)
+{
+    return cgLoop(A, nullptr, b, x, relTol, maxIter, stop, dot);
+}
+
+std::size_t solvePCG(const LinearOperatorDouble& A, const LinearOperatorDouble& M,
+                     const VectorDouble& b, VectorDouble& x,
+                     double relTol, std::size_t maxIter, const KrylovStop& stop,
+                     const KrylovDot& dot)
+{
+    return cgLoop(A, &M, b, x, relTol, maxIter, stop, dot);
+}
+
+std::size_t solveGMRES(const LinearOperatorDouble& A, const VectorDouble& b, VectorDouble& x,
+                       double relTol, std::size_t maxIter, std::size_t restart,
+                       const KrylovStop& stop, const KrylovDot& dot)
+{
+    checkDims(A, b, x);
+
+    const std::size_t n = x.size();
+    const double bnorm = std::sqrt(innerProduct(dot, b, b));
+    const double target = relTol * (bnorm > 0.0 ? bnorm : 1.0);
+    const std::size_t m = std::max<std::size_t>(1, restart);
+
+    // Hessenberg matrix column-major with m + 1 rows, Givens rotations, rhs
+    std::vector<double> H((m + 1) * m);
+    std::vector<double> cs(m), sn(m), g(m + 1), y(m);
+    std::vector<VectorDouble> V;
+    V.reserve(m + 1);
+    VectorDouble w(n);
+
+    auto h = [&](std::size_t i, std::size_t j) -> double& { return H[j * (m + 1) + i]; };
+
+    std::size_t it = 0;
+    for (;;) {
+        VectorDouble r = b - (A * x);
+        const double beta = std::sqrt(innerProduct(dot, r, r));
+        if (beta <= target)
+            return it;
+        if (it >= maxIter)
+            throw std::runtime_error("Error: GMRES did not converge within maxIter");
+
+        V.clear();
+        V.push_back(r * (1.0 / beta));
+        std::fill(g.begin(), g.end(), 0.0);
+        g[0] = beta;
+
+        std::size_t j = 0;
+        while (j < m && it < maxIter) {
+            if (stop && stop())
+                throw KrylovStopped();
+            A.apply(V[j], w);
+
+            // modified Gram-Schmidt
+            for (std::size_t i = 0; i <= j; ++i) {
+                h(i, j) = innerProduct(dot, w, V[i]);
+                w.axpy(-h(i, j), V[i]);
+            }
+            const double hNext = std::sqrt(innerProduct(dot, w, w));
+            h(j + 1, j) = hNext;
+
+            for (std::size_t i = 0; i < j; ++i) {
+                const double t = cs[i] * h(i, j) + sn[i] * h(i + 1, j);
+                h(i + 1, j) = -sn[i] * h(i, j) + cs[i] * h(i + 1, j);
+                h(i, j) = t;
+            }
+
+            const double d = std::hypot(h(j, j), h(j + 1, j));
+            if (d == 0.0)
+                throw KrylovBreakdown("Error: GMRES breakdown, singular operator");
+            cs[j] = h(j, j) / d;
+            sn[j] = h(j + 1, j) / d;
+            h(j, j) = d;
+            h(j + 1, j) = 0.0;
+            g[j + 1] = -sn[j] * g[j];
+            g[j] = cs[j] * g[j];
+
+            ++j;
+            ++it;
+
+            if (hNext == 0.0 || std::abs(g[j]) <= target)
+                break;
+            if (j < m)
+                V.push_back(w * (1.0 / hNext));
+        }
+
+        // y = H(0:j, 0:j) \ g, then x += V y
+        for (std::size_t i = j; i-- > 0;) {
+            double s = g[i];
+            for (std::size_t k = i + 1; k < j; ++k)
+                s -= h(i, k) * y[k];
+            y[i] = s / h(i, i);
+        }
+        for (std::size_t i = 0; i < j; ++i)
+            x.axpy(y[i], V[i]);
+    }
+}
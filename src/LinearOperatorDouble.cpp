@@ -0,0 +1,43 @@
+#include "LinearOperatorDouble.hpp"
+#include <stdexcept>
+#include <utility>
+
+VectorDouble LinearOperatorDouble::operator*(const VectorDouble& x) const
+{
+    if (x.size() != size())
+        throw std::runtime_error("Error: Dimension mismatch in operator A*x");
+
+    VectorDouble y(size());
+    apply(x, y);
+    return y;
+}
+
+SparseMatrixOperatorDouble::SparseMatrixOperatorDouble(SparseSquareMatrixCRSDouble&& A)
+    : A_(std::move(A))
+{
+    A_.finalize();
+}
+
+std::size_t SparseMatrixOperatorDouble::size() const noexcept
+{
+    return A_.size();
+}
+
+void SparseMatrixOperatorDouble::apply(const VectorDouble& x, VectorDouble& y) const
+{
+    A_.multiply(x, y);
+}
+
+DenseMatrixOperatorDouble::DenseMatrixOperatorDouble(DenseSquareMatrixDouble&& A)
+    : A_(std::move(A))
+{}
+
+std::size_t DenseMatrixOperatorDouble::size() const noexcept
+{
+    return A_.size();
+}
+
+void DenseMatrixOperatorDouble::apply(const VectorDouble& x, VectorDouble& y) const
+{
+    y = A_ * x;
+}
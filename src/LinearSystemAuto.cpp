@@ -0,0 +1,200 @@
+#include "LinearSystemAuto.hpp"
+#include "KrylovSolvers.hpp"
+#include "SparseSquareMatrixBSRDouble.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+
+template <std::size_t B>
+class BSROperator : public LinearOperatorDouble {
+public:
+    explicit BSROperator(SparseSquareMatrixBSRDouble<B>&& A) : A_(std::move(A)) {}
+
+    std::size_t size() const noexcept override { return A_.size(); }
+    void apply(const VectorDouble& x, VectorDouble& y) const override { y = A_ * x; }
+
+private:
+    SparseSquareMatrixBSRDouble<B> A_;
+};
+
+struct BlockEntry {
+    std::size_t jb;
+    std::size_t q;  // position inside the B x B block
+    double v;
+};
+
+// forEachInRow(i, fn) calls fn(j, v) for every stored entry of row i
+template <std::size_t B, class RowFn>
+std::unique_ptr<LinearOperatorDouble> makeBSR(std::size_t n, RowFn forEachInRow)
+{
+    const std::size_t nb = n / B;
+    SparseSquareMatrixBSRDouble<B> A(nb);
+    std::vector<BlockEntry> entries;
+
+    // gather one block row at a time so every block is added exactly once
+    for (std::size_t ib = 0; ib < nb; ++ib) {
+        entries.clear();
+        for (std::size_t r = 0; r < B; ++r)
+            forEachInRow(ib * B + r, [&](std::size_t j, double v) {
+                if (v != 0.0)
+                    entries.push_back({j / B, r * B + j % B, v});
+            });
+
+        std::sort(entries.begin(), entries.end(),
+                  [](const BlockEntry& a, const BlockEntry& b) { return a.jb < b.jb; });
+
+        std::size_t k = 0;
+        while (k < entries.size()) {
+            typename SparseSquareMatrixBSRDouble<B>::Block blk{};
+            const std::size_t jb = entries[k].jb;
+            for (; k < entries.size() && entries[k].jb == jb; ++k)
+                blk[entries[k].q] += entries[k].v;
+            A.addBlock(ib, jb, blk);
+        }
+    }
+    A.finalize();
+
+    return std::make_unique<BSROperator<B>>(std::move(A));
+}
+
+template <class RowFn>
+std::unique_ptr<LinearOperatorDouble> makeBSR(std::size_t n, std::size_t B, RowFn forEachInRow)
+{
+    switch (B) {
+    case 2: return makeBSR<2>(n, forEachInRow);
+    case 3: return makeBSR<3>(n, forEachInRow);
+    case 4: return makeBSR<4>(n, forEachInRow);
+    }
+    throw std::runtime_error("Error: Unsupported BSR block size");
+}
+
+} // namespace
+
+LinearSystemAuto::LinearSystemAuto(DenseSquareMatrixDouble&& A, VectorDouble&& x, VectorDouble&& b)
+    : x_(std::move(x)), b_(std::move(b))
+{
+    if (A.size() != x_.size() || A.size() != b_.size())
+        throw std::runtime_error("Error: Dimension mismatch in LinearSystemAuto constructor");
+    build(&A, nullptr);
+}
+
+LinearSystemAuto::LinearSystemAuto(SparseSquareMatrixCRSDouble&& A, VectorDouble&& x, VectorDouble&& b)
+    : x_(std::move(x)), b_(std::move(b))
+{
+    if (A.size() != x_.size() || A.size() != b_.size())
+        throw std::runtime_error("Error: Dimension mismatch in LinearSystemAuto constructor");
+    A.finalize();
+    build(nullptr, &A);
+}
+
+void LinearSystemAuto::build(DenseSquareMatrixDouble* dense, SparseSquareMatrixCRSDouble* sparse)
+{
+    analysis_ = dense ? MatrixAnalysis::analyze(*dense) : MatrixAnalysis::analyze(*sparse);
+    plan_ = selectSolverPlan(analysis_);
+
+    const bool direct = plan_.solver == SolverKind::LU || plan_.solver == SolverKind::Cholesky;
+    const std::size_t n = analysis_.n;
+
+    switch (plan_.format) {
+    case StorageFormat::Dense: {
+        DenseSquareMatrixDouble D = dense ? std::move(*dense) : sparse->toDense();
+        if (direct)
+            dense_ = std::make_unique<DenseSquareMatrixDouble>(std::move(D));
+        else
+            op_ = std::make_unique<DenseMatrixOperatorDouble>(std::move(D));
+        break;
+    }
+    case StorageFormat::CRS: {
+        SparseSquareMatrixCRSDouble S = sparse ? std::move(*sparse)
+                                               : SparseSquareMatrixCRSDouble::fromDense(*dense);
+        op_ = std::make_unique<SparseMatrixOperatorDouble>(std::move(S));
+        break;
+    }
+    case StorageFormat::BSR:
+        if (dense) {
+            op_ = makeBSR(n, plan_.blockSize, [&](std::size_t i, auto&& fn) {
+                for (std::size_t j = 0; j < n; ++j)
+                    fn(j, (*dense)(i, j));
+            });
+        } else {
+            const std::size_t* rowPtr = sparse->rowPtrData();
+            const std::size_t* colInd = sparse->colIndData();
+            const double* val = sparse->valuesData();
+            op_ = makeBSR(n, plan_.blockSize, [&](std::size_t i, auto&& fn) {
+                fn(i, sparse->diagonal()[i]);
+                for (std::size_t p = rowPtr[i]; p < rowPtr[i + 1]; ++p)
+                    fn(colInd[p], val[p]);
+            });
+        }
+        break;
+    }
+}
+
+std::size_t LinearSystemAuto::size() const noexcept { return analysis_.n; }
+
+VectorDouble& LinearSystemAuto::x() { return x_; }
+VectorDouble& LinearSystemAuto::b() { return b_; }
+const VectorDouble& LinearSystemAuto::x() const { return x_; }
+const VectorDouble& LinearSystemAuto::b() const { return b_; }
+
+void LinearSystemAuto::applyA(const VectorDouble& x, VectorDouble& y) const
+{
+    if (dense_)
+        y = *dense_ * x;
+    else
+        op_->apply(x, y);
+}
+
+void LinearSystemAuto::multiply()
+{
+    applyA(x_, b_);
+}
+
+VectorDouble LinearSystemAuto::residual() const
+{
+    VectorDouble Ax(x_.size());
+    applyA(x_, Ax);
+    return b_ - Ax;
+}
+
+std::size_t LinearSystemAuto::solve(double relTol, std::size_t maxIter)
+{
+    switch (plan_.solver) {
+    case SolverKind::Cholesky:
+        if (!chol_) {
+            try {
+                chol_ = std::make_unique<DenseCholeskyDouble>(*dense_);
+            }
+            catch (const std::runtime_error&) {
+                // symmetric with a positive diagonal but not SPD
+                plan_.solver = SolverKind::LU;
+                return solve(relTol, maxIter);
+            }
+        }
+        x_ = chol_->solve(b_);
+        return 0;
+
+    case SolverKind::LU:
+        if (!lu_)
+            lu_ = std::make_unique<DenseLUDouble>(*dense_);
+        x_ = lu_->solve(b_);
+        return 0;
+
+    case SolverKind::CG:
+        try {
+            return solveCG(*op_, b_, x_, relTol, maxIter);
+        }
+        catch (const KrylovBreakdown&) {
+            // not SPD after all; non-convergence is not retried
+            plan_.solver = SolverKind::GMRES;
+        }
+        return solveGMRES(*op_, b_, x_, relTol, maxIter);
+
+    case SolverKind::GMRES:
+        return solveGMRES(*op_, b_, x_, relTol, maxIter);
+    }
+    return 0;
+}
@@ -1,9 +1,7 @@
 #include "LinearSystemDense.hpp"
+#include "DenseFactorizationDouble.hpp"
 #include <stdexcept>
 
-#include <cmath>
-#include <iostream>
-
 LinearSystemDense::LinearSystemDense(DenseSquareMatrixDouble&& A,
                                      VectorDouble&& x,
                                      VectorDouble&& b)
@@ -31,39 +29,22 @@ VectorDouble LinearSystemDense::residual() const
     return b_ - (A_ * x_);
 }
 
-bool LinearSystemDense::isSymmetric() const
+void LinearSystemDense::solveLU()
 {
-    // std::cout << "check for symmetry" << std::endl;
-    double TOL = 1e-12;
-    const std::size_t N = A_.size();
-
-    for (std::size_t i = 0; i < N; ++i) {
-        for (std::size_t j = i + 1; j < N; ++j) {
-            // std::cout << i << " " << j << " " << std::abs(A_(i, j) - A_(j, i)) << std::endl;
-            if (std::abs(A_(i, j) - A_(j, i)) > TOL) {
-                // std::cout << std::abs(A_(i, j) - A_(j, i)) << std::endl;
-                return false;
-            }
-        }
-    }
-    return true;
+    x_ = DenseLUDouble(A_).solve(b_);
 }
 
-bool LinearSystemDense::isDiagonallyDominant() const
+void LinearSystemDense::solveCholesky()
 {
-    const std::size_t N = A_.size();
-
-    for (std::size_t i = 0; i < N; ++i) {
-        double diag = std::abs(A_(i, i));
-        double off_sum = 0.0;
+    x_ = DenseCholeskyDouble(A_).solve(b_);
+}
 
-        for (std::size_t j = 0; j < N; ++j) {
-            if (j == i) continue;
-            off_sum += std::abs(A_(i, j));
-        }
+bool LinearSystemDense::isSymmetric(double absTol, double relTol) const
+{
+    return A_.isSymmetric(absTol, relTol);
+}
 
-        if (diag < off_sum)
-            return false;
-    }
-    return true;
+bool LinearSystemDense::isDiagonallyDominant(double relTol) const
+{
+    return A_.isDiagonallyDominant(relTol);
 }
@@ -0,0 +1,302 @@
+#include "LinearSystemDenseBatched.hpp"
+#include "ComputePool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+constexpr std::size_t W = LinearSystemDenseBatched::Lanes;
+
+// y = A x for one group; A is N*N*W, x and y are N*W
+void groupGemv(std::size_t N, const double* A, const double* x, double* y)
+{
+    for (std::size_t i = 0; i < N; ++i) {
+        double sum[W] = {};
+        for (std::size_t j = 0; j < N; ++j) {
+            const double* a = A + (i * N + j) * W;
+            const double* xj = x + j * W;
+            for (std::size_t l = 0; l < W; ++l)
+                sum[l] += a[l] * xj[l];
+        }
+        for (std::size_t l = 0; l < W; ++l)
+            y[i * W + l] = sum[l];
+    }
+}
+
+// LU with partial pivoting on a copy M of the group, then x = U \ (L \ y).
+// The pivot search and row swap are per lane, the elimination is across lanes.
+void groupSolveLU(std::size_t N, std::size_t firstSystem, double* M, double* y, double* x)
+{
+    for (std::size_t k = 0; k < N; ++k) {
+        for (std::size_t l = 0; l < W; ++l) {
+            std::size_t piv = k;
+            double best = std::abs(M[(k * N + k) * W + l]);
+            for (std::size_t i = k + 1; i < N; ++i) {
+                const double v = std::abs(M[(i * N + k) * W + l]);
+                if (v > best) {
+                    best = v;
+                    piv = i;
+                }
+            }
+            if (best == 0.0)
+                throw std::runtime_error("Error: Singular matrix in batched LU (system "
+                                         + std::to_string(firstSystem + l) + ")");
+            if (piv != k) {
+                for (std::size_t j = 0; j < N; ++j)
+                    std::swap(M[(k * N + j) * W + l], M[(piv * N + j) * W + l]);
+                std::swap(y[k * W + l], y[piv * W + l]);
+            }
+        }
+
+        double inv[W];
+        for (std::size_t l = 0; l < W; ++l)
+            inv[l] = 1.0 / M[(k * N + k) * W + l];
+
+        for (std::size_t i = k + 1; i < N; ++i) {
+            double f[W];
+            for (std::size_t l = 0; l < W; ++l)
+                f[l] = M[(i * N + k) * W + l] * inv[l];
+
+            for (std::size_t j = k + 1; j < N; ++j) {
+                double* mij = M + (i * N + j) * W;
+                const double* mkj = M + (k * N + j) * W;
+                for (std::size_t l = 0; l < W; ++l)
+                    mij[l] -= f[l] * mkj[l];
+            }
+            for (std::size_t l = 0; l < W; ++l)
+                y[i * W + l] -= f[l] * y[k * W + l];
+        }
+    }
+
+    for (std::size_t ii = N; ii-- > 0;) {
+        double sum[W];
+        for (std::size_t l = 0; l < W; ++l)
+            sum[l] = y[ii * W + l];
+        for (std::size_t j = ii + 1; j < N; ++j) {
+            const double* m = M + (ii * N + j) * W;
+            for (std::size_t l = 0; l < W; ++l)
+                sum[l] -= m[l] * x[j * W + l];
+        }
+        for (std::size_t l = 0; l < W; ++l)
+            x[ii * W + l] = sum[l] / M[(ii * N + ii) * W + l];
+    }
+}
+
+// Cholesky A = L L^T in the lower triangle of M, then x = L^T \ (L \ y)
+void groupSolveCholesky(std::size_t N, std::size_t firstSystem, double* M, double* y, double* x)
+{
+    for (std::size_t j = 0; j < N; ++j) {
+        double d[W];
+        for (std::size_t l = 0; l < W; ++l)
+            d[l] = M[(j * N + j) * W + l];
+        for (std::size_t k = 0; k < j; ++k) {
+            const double* ljk = M + (j * N + k) * W;
+            for (std::size_t l = 0; l < W; ++l)
+                d[l] -= ljk[l] * ljk[l];
+        }
+        for (std::size_t l = 0; l < W; ++l) {
+            if (!(d[l] > 0.0))
+                throw std::runtime_error("Error: Matrix not positive definite in batched Cholesky (system "
+                                         + std::to_string(firstSystem + l) + ")");
+            M[(j * N + j) * W + l] = std::sqrt(d[l]);
+        }
+
+        for (std::size_t i = j + 1; i < N; ++i) {
+            double s[W];
+            for (std::size_t l = 0; l < W; ++l)
+                s[l] = M[(i * N + j) * W + l];
+            for (std::size_t k = 0; k < j; ++k) {
+                const double* lik = M + (i * N + k) * W;
+                const double* ljk = M + (j * N + k) * W;
+                for (std::size_t l = 0; l < W; ++l)
+                    s[l] -= lik[l] * ljk[l];
+            }
+            for (std::size_t l = 0; l < W; ++l)
+                M[(i * N + j) * W + l] = s[l] / M[(j * N + j) * W + l];
+        }
+    }
+
+    // forward: L z = y, z stored in y
+    for (std::size_t i = 0; i < N; ++i) {
+        for (std::size_t k = 0; k < i; ++k) {
+            const double* lik = M + (i * N + k) * W;
+            for (std::size_t l = 0; l < W; ++l)
+                y[i * W + l] -= lik[l] * y[k * W + l];
+        }
+        for (std::size_t l = 0; l < W; ++l)
+            y[i * W + l] /= M[(i * N + i) * W + l];
+    }
+
+    // backward: L^T x = z
+    for (std::size_t ii = N; ii-- > 0;) {
+        double sum[W];
+        for (std::size_t l = 0; l < W; ++l)
+            sum[l] = y[ii * W + l];
+        for (std::size_t k = ii + 1; k < N; ++k) {
+            const double* lki = M + (k * N + ii) * W;
+            for (std::size_t l = 0; l < W; ++l)
+                sum[l] -= lki[l] * x[k * W + l];
+        }
+        for (std::size_t l = 0; l < W; ++l)
+            x[ii * W + l] = sum[l] / M[(ii * N + ii) * W + l];
+    }
+}
+
+} // namespace
+
+LinearSystemDenseBatched::LinearSystemDenseBatched(std::size_t N, std::size_t count)
+    : N_(N), count_(count), groups_((count + W - 1) / W),
+      A_(groups_ * N * N * W, 0.0), x_(groups_ * N * W, 0.0), b_(groups_ * N * W, 0.0)
+{
+    // identity in the padding lanes keeps every solve well posed
+    for (std::size_t s = count_; s < groups_ * W; ++s)
+        for (std::size_t i = 0; i < N_; ++i)
+            A_[index(s, i * N_ + i, N_ * N_)] = 1.0;
+}
+
+std::size_t LinearSystemDenseBatched::size() const noexcept { return N_; }
+std::size_t LinearSystemDenseBatched::count() const noexcept { return count_; }
+
+std::size_t LinearSystemDenseBatched::index(std::size_t s, std::size_t k, std::size_t per) noexcept
+{
+    return ((s / W) * per + k) * W + s % W;
+}
+
+void LinearSystemDenseBatched::checkSystem(std::size_t s) const
+{
+    if (s >= count_)
+        throw std::runtime_error("Error: System index out of range in LinearSystemDenseBatched");
+}
+
+double& LinearSystemDenseBatched::A(std::size_t s, std::size_t i, std::size_t j)
+{
+    return A_[index(s, i * N_ + j, N_ * N_)];
+}
+
+double& LinearSystemDenseBatched::x(std::size_t s, std::size_t i) { return x_[index(s, i, N_)]; }
+double& LinearSystemDenseBatched::b(std::size_t s, std::size_t i) { return b_[index(s, i, N_)]; }
+
+const double& LinearSystemDenseBatched::A(std::size_t s, std::size_t i, std::size_t j) const
+{
+    return A_[index(s, i * N_ + j, N_ * N_)];
+}
+
+const double& LinearSystemDenseBatched::x(std::size_t s, std::size_t i) const { return x_[index(s, i, N_)]; }
+const double& LinearSystemDenseBatched::b(std::size_t s, std::size_t i) const { return b_[index(s, i, N_)]; }
+
+void LinearSystemDenseBatched::setSystem(std::size_t s, const DenseSquareMatrixDouble& A,
+                                         const VectorDouble& x, const VectorDouble& b)
+{
+    checkSystem(s);
+    if (A.size() != N_ || x.size() != N_ || b.size() != N_)
+        throw std::runtime_error("Error: Dimension mismatch in LinearSystemDenseBatched::setSystem");
+
+    for (std::size_t i = 0; i < N_; ++i) {
+        for (std::size_t j = 0; j < N_; ++j)
+            this->A(s, i, j) = A(i, j);
+        this->x(s, i) = x[i];
+        this->b(s, i) = b[i];
+    }
+}
+
+VectorDouble LinearSystemDenseBatched::getX(std::size_t s) const
+{
+    checkSystem(s);
+
+    VectorDouble result(N_);
+    for (std::size_t i = 0; i < N_; ++i)
+        result[i] = x(s, i);
+    return result;
+}
+
+void LinearSystemDenseBatched::multiply()
+{
+    if (N_ == 0)
+        return;
+    const std::size_t NN = N_ * N_;
+
+    parallelFor(groups_, 1, [&](std::size_t g0, std::size_t g1) {
+        for (std::size_t g = g0; g < g1; ++g)
+            groupGemv(N_, &A_[g * NN * W], &x_[g * N_ * W], &b_[g * N_ * W]);
+    });
+}
+
+VectorDouble LinearSystemDenseBatched::residual(std::size_t s) const
+{
+    checkSystem(s);
+
+    VectorDouble r(N_);
+    for (std::size_t i = 0; i < N_; ++i) {
+        double sum = b(s, i);
+        for (std::size_t j = 0; j < N_; ++j)
+            sum -= A(s, i, j) * x(s, j);
+        r[i] = sum;
+    }
+    return r;
+}
+
+VectorDouble LinearSystemDenseBatched::residualNormInf() const
+{
+    const std::size_t NN = N_ * N_;
+    VectorDouble norms(count_);
+    if (N_ == 0)
+        return norms;
+
+    parallelFor(groups_, 1, [&](std::size_t g0, std::size_t g1) {
+        std::vector<double> Ax(N_ * W);
+        for (std::size_t g = g0; g < g1; ++g) {
+            groupGemv(N_, &A_[g * NN * W], &x_[g * N_ * W], Ax.data());
+
+            double m[W] = {};
+            const double* bg = &b_[g * N_ * W];
+            for (std::size_t k = 0; k < N_ * W; k += W)
+                for (std::size_t l = 0; l < W; ++l) {
+                    // NaN is sticky, as in VectorDouble::normInf
+                    const double d = std::abs(bg[k + l] - Ax[k + l]);
+                    if (d > m[l] || std::isnan(d))
+                        m[l] = d;
+                }
+
+            for (std::size_t l = 0; l < W && g * W + l < count_; ++l)
+                norms[g * W + l] = m[l];
+        }
+    });
+
+    return norms;
+}
+
+void LinearSystemDenseBatched::solveLU()
+{
+    if (N_ == 0)
+        return;
+    const std::size_t NN = N_ * N_;
+
+    parallelFor(groups_, 1, [&](std::size_t g0, std::size_t g1) {
+        std::vector<double> M(NN * W);
+        std::vector<double> y(N_ * W);
+        for (std::size_t g = g0; g < g1; ++g) {
+            std::copy_n(&A_[g * NN * W], NN * W, M.data());
+            std::copy_n(&b_[g * N_ * W], N_ * W, y.data());
+            groupSolveLU(N_, g * W, M.data(), y.data(), &x_[g * N_ * W]);
+        }
+    });
+}
+
+void LinearSystemDenseBatched::solveCholesky()
+{
+    if (N_ == 0)
+        return;
+    const std::size_t NN = N_ * N_;
+
+    parallelFor(groups_, 1, [&](std::size_t g0, std::size_t g1) {
+        std::vector<double> M(NN * W);
+        std::vector<double> y(N_ * W);
+        for (std::size_t g = g0; g < g1; ++g) {
+            std::copy_n(&A_[g * NN * W], NN * W, M.data());
+            std::copy_n(&b_[g * N_ * W], N_ * W, y.data());
+            groupSolveCholesky(N_, g * W, M.data(), y.data(), &x_[g * N_ * W]);
+        }
+    });
+}
@@ -0,0 +1,43 @@
+#include "LinearSystemOperator.hpp"
+#include "KrylovSolvers.hpp"
+#include <stdexcept>
+#include <utility>
+
+LinearSystemOperator::LinearSystemOperator(std::unique_ptr<LinearOperatorDouble> A,
+                                           VectorDouble&& x,
+                                           VectorDouble&& b)
+    : A_(std::move(A)), x_(std::move(x)), b_(std::move(b))
+{
+    if (!A_)
+        throw std::runtime_error("Error: Null operator in LinearSystemOperator constructor");
+    const std::size_t N = A_->size();
+    if (x_.size() != N || b_.size() != N)
+        throw std::runtime_error("Error: Dimension mismatch in LinearSystemOperator constructor");
+}
+
+const LinearOperatorDouble& LinearSystemOperator::A() const { return *A_; }
+VectorDouble& LinearSystemOperator::x() { return x_; }
+VectorDouble& LinearSystemOperator::b() { return b_; }
+
+const VectorDouble& LinearSystemOperator::x() const { return x_; }
+const VectorDouble& LinearSystemOperator::b() const { return b_; }
+
+void LinearSystemOperator::multiply()
+{
+    A_->apply(x_, b_);
+}
+
+VectorDouble LinearSystemOperator::residual() const
+{
+    return b_ - (*A_ * x_);
+}
+
+std::size_t LinearSystemOperator::solveCG(double relTol, std::size_t maxIter)
+{
+    return ::solveCG(*A_, b_, x_, relTol, maxIter);
+}
+
+std::size_t LinearSystemOperator::solveGMRES(double relTol, std::size_t maxIter, std::size_t restart)
+{
+    return ::solveGMRES(*A_, b_, x_, relTol, maxIter, restart);
+}
@@ -29,3 +29,13 @@ VectorDouble LinearSystemSparse::residual() const
 {
     return b_ - (A_ * x_);
 }
+
+bool LinearSystemSparse::isSymmetric(double absTol, double relTol) const
+{
+    return A_.isSymmetric(absTol, relTol);
+}
+
+bool LinearSystemSparse::isDiagonallyDominant(double relTol) const
+{
+    return A_.isDiagonallyDominant(relTol);
+}
@@ -0,0 +1,67 @@
+#ifdef LA_WITH_MPI
+
+#include "LinearSystemSparseDistributed.hpp"
+#include "KrylovSolvers.hpp"
+#include "LinearOperatorDouble.hpp"
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// the owned rows of a distributed matrix as an operator on local slices
+class LocalRowsOperator : public LinearOperatorDouble {
+public:
+    explicit LocalRowsOperator(const DistributedSparseMatrixCRSDouble& A) : A_(A) {}
+    std::size_t size() const noexcept override { return A_.localRows(); }
+    void apply(const VectorDouble& x, VectorDouble& y) const override { A_.multiplyLocal(x, y); }
+
+private:
+    const DistributedSparseMatrixCRSDouble& A_;
+};
+
+} // namespace
+
+LinearSystemSparseDistributed::LinearSystemSparseDistributed(DistributedSparseMatrixCRSDouble&& A,
+                                                             DistributedVectorDouble&& x,
+                                                             DistributedVectorDouble&& b)
+    : A_(std::move(A)), x_(std::move(x)), b_(std::move(b))
+{
+    const std::size_t N = A_.globalSize();
+    if (x_.globalSize() != N || b_.globalSize() != N)
+        throw std::runtime_error("Error: Dimension mismatch in LinearSystemSparseDistributed constructor");
+
+    A_.finalize();
+}
+
+DistributedSparseMatrixCRSDouble& LinearSystemSparseDistributed::A() { return A_; }
+DistributedVectorDouble& LinearSystemSparseDistributed::x() { return x_; }
+DistributedVectorDouble& LinearSystemSparseDistributed::b() { return b_; }
+
+const DistributedSparseMatrixCRSDouble& LinearSystemSparseDistributed::A() const { return A_; }
+const DistributedVectorDouble& LinearSystemSparseDistributed::x() const { return x_; }
+const DistributedVectorDouble& LinearSystemSparseDistributed::b() const { return b_; }
+
+void LinearSystemSparseDistributed::multiply()
+{
+    A_.multiply(x_, b_);
+}
+
+DistributedVectorDouble LinearSystemSparseDistributed::residual() const
+{
+    return b_ - (A_ * x_);
+}
+
+std::size_t LinearSystemSparseDistributed::solveCG(double relTol, std::size_t maxIter)
+{
+    // the shared CG on the owned slices, inner products summed over the ranks
+    const MPI_Comm comm = x_.comm();
+    const KrylovDot dot = [comm](const VectorDouble& a, const VectorDouble& b) {
+        double local = a.dot(b);
+        double global = 0.0;
+        MPI_Allreduce(&local, &global, 1, MPI_DOUBLE, MPI_SUM, comm);
+        return global;
+    };
+    return ::solveCG(LocalRowsOperator(A_), b_.local(), x_.local(), relTol, maxIter, nullptr, dot);
+}
+
+#endif // LA_WITH_MPI
@@ -0,0 +1,229 @@
+#include "MatrixAnalysis.hpp"
+#include "ComputePool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// selection thresholds
+constexpr std::size_t kSmallN = 64;        // always dense below this
+constexpr double kDenseDensity = 0.25;     // CRS costs ~16 B/nnz vs 8 B/entry dense
+constexpr std::size_t kDirectMaxN = 4000;  // largest n factored densely
+constexpr double kBlockFill = 0.75;
+
+constexpr std::size_t kBlockSizes[] = {4, 3, 2};
+
+// row-length statistics and density from per-row nonzero counts
+void fillRowStats(MatrixAnalysis& a, const std::vector<std::size_t>& rowNnz)
+{
+    const std::size_t n = rowNnz.size();
+    if (n == 0)
+        return;
+
+    a.minRowNnz = *std::min_element(rowNnz.begin(), rowNnz.end());
+    a.maxRowNnz = *std::max_element(rowNnz.begin(), rowNnz.end());
+
+    std::size_t total = 0;
+    for (std::size_t c : rowNnz)
+        total += c;
+    a.nnz = total;
+    a.meanRowNnz = static_cast<double>(total) / static_cast<double>(n);
+
+    double var = 0.0;
+    for (std::size_t c : rowNnz) {
+        const double d = static_cast<double>(c) - a.meanRowNnz;
+        var += d * d;
+    }
+    a.stddevRowNnz = std::sqrt(var / static_cast<double>(n));
+    a.density = static_cast<double>(total) / (static_cast<double>(n) * static_cast<double>(n));
+}
+
+// Count nonzero B x B blocks. colsOfBlockRow(bi, out) appends the block
+// column (j / B) of every nonzero in block row bi.
+template <class ColsFn>
+std::size_t countBlocks(std::size_t n, std::size_t B, ColsFn colsOfBlockRow)
+{
+    const std::size_t nb = n / B;
+    std::vector<std::size_t> counts(nb, 0);
+
+    parallelFor(nb, 16, [&](std::size_t b0, std::size_t b1) {
+        std::vector<std::size_t> cols;
+        for (std::size_t bi = b0; bi < b1; ++bi) {
+            cols.clear();
+            colsOfBlockRow(bi, cols);
+            std::sort(cols.begin(), cols.end());
+            counts[bi] = static_cast<std::size_t>(std::unique(cols.begin(), cols.end()) - cols.begin());
+        }
+    });
+
+    std::size_t total = 0;
+    for (std::size_t c : counts)
+        total += c;
+    return total;
+}
+
+template <class ColsFn>
+std::size_t detectBlockSize(std::size_t n, std::size_t nnz, ColsFn colsOfBlockRow)
+{
+    for (std::size_t B : kBlockSizes) {
+        if (n < B || n % B != 0)
+            continue;
+        const std::size_t blocks = countBlocks(n, B, [&](std::size_t bi, std::vector<std::size_t>& out) {
+            colsOfBlockRow(B, bi, out);
+        });
+        if (blocks > 0 && static_cast<double>(nnz) >= kBlockFill * static_cast<double>(blocks * B * B))
+            return B;
+    }
+    return 1;
+}
+
+} // namespace
+
+MatrixAnalysis MatrixAnalysis::analyze(const DenseSquareMatrixDouble& A)
+{
+    MatrixAnalysis a;
+    const std::size_t n = A.size();
+    a.n = n;
+    if (n == 0)
+        return a;
+
+    const double* d = A.data();
+    std::vector<std::size_t> rowNnz(n, 0);
+    std::vector<std::size_t> rowBand(n, 0);
+    std::vector<char> rowPosDiag(n, 0);
+
+    parallelFor(n, 64, [&](std::size_t i0, std::size_t i1) {
+        for (std::size_t i = i0; i < i1; ++i) {
+            const double* row = d + i * n;
+            std::size_t cnt = 0, first = n, last = 0;
+            for (std::size_t j = 0; j < n; ++j) {
+                if (row[j] != 0.0) {
+                    ++cnt;
+                    first = std::min(first, j);
+                    last = j;
+                }
+            }
+            rowNnz[i] = cnt;
+            if (cnt > 0)
+                rowBand[i] = std::max(i > first ? i - first : 0, last > i ? last - i : 0);
+            rowPosDiag[i] = row[i] > 0.0;
+        }
+    });
+
+    fillRowStats(a, rowNnz);
+    a.bandwidth = *std::max_element(rowBand.begin(), rowBand.end());
+    a.positiveDiagonal = std::all_of(rowPosDiag.begin(), rowPosDiag.end(), [](char c) { return c != 0; });
+    a.symmetric = A.isSymmetric();
+    a.diagonallyDominant = A.isDiagonallyDominant();
+
+    a.blockSize = detectBlockSize(n, a.nnz, [&](std::size_t B, std::size_t bi, std::vector<std::size_t>& out) {
+        for (std::size_t i = bi * B; i < (bi + 1) * B; ++i)
+            for (std::size_t j = 0; j < n; ++j)
+                if (d[i * n + j] != 0.0)
+                    out.push_back(j / B);
+    });
+
+    return a;
+}
+
+MatrixAnalysis MatrixAnalysis::analyze(const SparseSquareMatrixCRSDouble& A)
+{
+    MatrixAnalysis a;
+    const std::size_t n = A.size();
+    a.n = n;
+    if (n == 0)
+        return a;
+
+    if (!A.isFinalized())
+        throw std::runtime_error("Error: SparseSquareMatrixCRSDouble not finalized()");
+
+    const std::size_t* rowPtr = A.rowPtrData();
+    const std::size_t* colInd = A.colIndData();
+    const double* val = A.valuesData();
+    const VectorDouble& diag = A.diagonal();
+
+    std::vector<std::size_t> rowNnz(n, 0);
+    std::vector<std::size_t> rowBand(n, 0);
+    std::vector<char> rowPosDiag(n, 0);
+
+    parallelFor(n, 256, [&](std::size_t i0, std::size_t i1) {
+        for (std::size_t i = i0; i < i1; ++i) {
+            std::size_t cnt = diag[i] != 0.0 ? 1 : 0;
+            std::size_t band = 0;
+            for (std::size_t p = rowPtr[i]; p < rowPtr[i + 1]; ++p) {
+                if (val[p] == 0.0)
+                    continue;
+                ++cnt;
+                const std::size_t j = colInd[p];
+                band = std::max(band, i > j ? i - j : j - i);
+            }
+            rowNnz[i] = cnt;
+            rowBand[i] = band;
+            rowPosDiag[i] = diag[i] > 0.0;
+        }
+    });
+
+    fillRowStats(a, rowNnz);
+    a.bandwidth = *std::max_element(rowBand.begin(), rowBand.end());
+    a.positiveDiagonal = std::all_of(rowPosDiag.begin(), rowPosDiag.end(), [](char c) { return c != 0; });
+    a.symmetric = A.isSymmetric();
+    a.diagonallyDominant = A.isDiagonallyDominant();
+
+    a.blockSize = detectBlockSize(n, a.nnz, [&](std::size_t B, std::size_t bi, std::vector<std::size_t>& out) {
+        for (std::size_t i = bi * B; i < (bi + 1) * B; ++i) {
+            if (diag[i] != 0.0)
+                out.push_back(i / B);
+            for (std::size_t p = rowPtr[i]; p < rowPtr[i + 1]; ++p)
+                if (val[p] != 0.0)
+                    out.push_back(colInd[p] / B);
+        }
+    });
+
+    return a;
+}
+
+SolverPlan selectSolverPlan(const MatrixAnalysis& a)
+{
+    SolverPlan plan;
+    const bool spdLikely = a.symmetric && a.positiveDiagonal;
+
+    if (a.n <= kSmallN || (a.density >= kDenseDensity && a.n <= kDirectMaxN)) {
+        plan.format = StorageFormat::Dense;
+        plan.solver = spdLikely ? SolverKind::Cholesky : SolverKind::LU;
+        return plan;
+    }
+
+    if (a.density >= kDenseDensity) {
+        plan.format = StorageFormat::Dense;
+    } else if (a.blockSize > 1) {
+        plan.format = StorageFormat::BSR;
+        plan.blockSize = a.blockSize;
+    } else {
+        plan.format = StorageFormat::CRS;
+    }
+    plan.solver = spdLikely ? SolverKind::CG : SolverKind::GMRES;
+    return plan;
+}
+
+const char* storageFormatName(StorageFormat f)
+{
+    switch (f) {
+    case StorageFormat::Dense: return "dense";
+    case StorageFormat::CRS:   return "crs";
+    case StorageFormat::BSR:   return "bsr";
+    }
+    return "unknown";
+}
+
+const char* solverKindName(SolverKind s)
+{
+    switch (s) {
+    case SolverKind::LU:       return "lu";
+    case SolverKind::Cholesky: return "cholesky";
+    case SolverKind::CG:       return "cg";
+    case SolverKind::GMRES:    return "gmres";
+    }
+    return "unknown";
+}
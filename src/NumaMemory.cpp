@@ -0,0 +1,102 @@
+#include "NumaMemory.hpp"
+#include "ComputePool.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+void firstTouchFill(double* p, std::size_t n, double value)
+{
+    if (n < kFirstTouchMin) {
+        std::fill(p, p + n, value);
+        return;
+    }
+    parallelFor(n, kRowGrain, [&](std::size_t i0, std::size_t i1) {
+        std::fill(p + i0, p + i1, value);
+    });
+}
+
+void firstTouchCopy(double* dst, const double* src, std::size_t n)
+{
+    if (n < kFirstTouchMin) {
+        std::copy(src, src + n, dst);
+        return;
+    }
+    parallelFor(n, kRowGrain, [&](std::size_t i0, std::size_t i1) {
+        std::copy(src + i0, src + i1, dst + i0);
+    });
+}
+
+void firstTouchFillRows(double* p, std::size_t rows, std::size_t cols, double value)
+{
+    if (rows * cols < kFirstTouchMin) {
+        std::fill(p, p + rows * cols, value);
+        return;
+    }
+    parallelFor(rows, kRowGrain, [&](std::size_t i0, std::size_t i1) {
+        std::fill(p + i0 * cols, p + i1 * cols, value);
+    });
+}
+
+void firstTouchCopyRows(double* dst, const double* src, std::size_t rows, std::size_t cols)
+{
+    if (rows * cols < kFirstTouchMin) {
+        std::copy(src, src + rows * cols, dst);
+        return;
+    }
+    parallelFor(rows, kRowGrain, [&](std::size_t i0, std::size_t i1) {
+        std::copy(src + i0 * cols, src + i1 * cols, dst + i0 * cols);
+    });
+}
+
+int numaNodeCount()
+{
+    // "0" or "0-1" or "0,2-3"; the last id + 1 is enough for a node mask
+    std::ifstream in("/sys/devices/system/node/online");
+    std::string s;
+    if (!(in >> s) || s.empty())
+        return 1;
+
+    const std::size_t pos = s.find_last_of(",-");
+    const long last = std::strtol(s.c_str() + (pos == std::string::npos ? 0 : pos + 1), nullptr, 10);
+    return last >= 0 ? static_cast<int>(last) + 1 : 1;
+}
+
+bool numaBind(void* p, std::size_t bytes, int node)
+{
+#if defined(__linux__) && defined(SYS_mbind)
+    constexpr int kMpolBind = 2;
+    constexpr unsigned kMpolMfMove = 1u << 1;
+    constexpr int kMaxNodes = 1024;
+    constexpr int kBitsPerWord = 8 * sizeof(unsigned long);
+
+    if (node < 0 || node >= kMaxNodes || p == nullptr)
+        return false;
+
+    const long page = ::sysconf(_SC_PAGESIZE);
+    if (page <= 0)
+        return false;
+    const std::uintptr_t pg = static_cast<std::uintptr_t>(page);
+    const std::uintptr_t begin = (reinterpret_cast<std::uintptr_t>(p) + pg - 1) & ~(pg - 1);
+    const std::uintptr_t end = (reinterpret_cast<std::uintptr_t>(p) + bytes) & ~(pg - 1);
+    if (end <= begin)
+        return false;
+
+    unsigned long mask[kMaxNodes / kBitsPerWord] = {};
+    mask[node / kBitsPerWord] = 1ul << (node % kBitsPerWord);
+
+    return ::syscall(SYS_mbind, begin, end - begin, kMpolBind, mask,
+                     static_cast<unsigned long>(kMaxNodes), kMpolMfMove) == 0;
+#else
+    (void)p;
+    (void)bytes;
+    (void)node;
+    return false;
+#endif
+}
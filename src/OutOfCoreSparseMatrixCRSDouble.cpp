@@ -0,0 +1,453 @@
+#include "OutOfCoreSparseMatrixCRSDouble.hpp"
+#include "ComputePool.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#error "OutOfCoreSparseMatrixCRSDouble needs POSIX file I/O (open, pread, fstat)"
+#endif
+
+namespace {
+
+constexpr std::uint64_t kMagic = 0x3130305352434c41ULL;  // "LACRS001"
+constexpr std::size_t kHeaderWords = 5;
+constexpr std::size_t kIndexWords = 4;
+
+std::size_t chunkBytes(std::size_t rows, std::size_t nnz)
+{
+    return rows * sizeof(double) + (rows + 1) * sizeof(std::uint64_t)
+         + nnz * (sizeof(std::uint64_t) + sizeof(double));
+}
+
+// chunkBytes() without overflow, for sizes read from the file
+bool checkedChunkBytes(std::uint64_t rows, std::uint64_t nnz, std::size_t& bytes)
+{
+    // every field is at most 16 bytes per row or entry
+    constexpr std::uint64_t kMax = std::numeric_limits<std::size_t>::max() / 16;
+    if (rows >= kMax || nnz >= kMax - rows)
+        return false;
+    bytes = chunkBytes(rows, nnz);
+    return true;
+}
+
+// [offset, offset + bytes) lies inside a file of fileSize bytes
+bool fitsInFile(std::uint64_t offset, std::uint64_t bytes, std::uint64_t fileSize)
+{
+    return offset <= fileSize && bytes <= fileSize - offset;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Writer
+// ---------------------------------------------------------------------------
+
+OutOfCoreSparseMatrixCRSDouble::Writer::Writer(const std::string& path, std::size_t N,
+                                               std::size_t chunkBytes)
+    : f_(std::fopen(path.c_str(), "wb")),
+      N_(N),
+      chunkBytes_(chunkBytes),
+      nextRow_(0),
+      nnz_(0),
+      offset_(0),
+      finished_(false),
+      chunkBegin_(0),
+      rowPtr_(1, 0)
+{
+    if (!f_)
+        throw std::runtime_error("Error: Cannot open " + path + " for writing");
+
+    // placeholder header (zero magic) until finish()
+    const std::uint64_t header[kHeaderWords] = {0, 0, 0, 0, 0};
+    writeBytes(header, sizeof(header));
+}
+
+OutOfCoreSparseMatrixCRSDouble::Writer::~Writer()
+{
+    if (f_)
+        std::fclose(f_);
+}
+
+void OutOfCoreSparseMatrixCRSDouble::Writer::addRow(std::size_t i, const std::size_t* cols,
+                                                    const double* vals, std::size_t count)
+{
+    if (finished_)
+        throw std::runtime_error("Error: Cannot addRow after finish()");
+    if (i < nextRow_ || i >= N_)
+        throw std::runtime_error("Error: addRow rows must be increasing and in range");
+
+    while (nextRow_ < i) {
+        diag_.push_back(0.0);
+        rowPtr_.push_back(colInd_.size());
+        ++nextRow_;
+        if (chunkBytes(diag_.size(), colInd_.size()) >= chunkBytes_)
+            flushChunk();
+    }
+
+    double d = 0.0;
+    for (std::size_t k = 0; k < count; ++k) {
+        if (cols[k] >= N_)
+            throw std::runtime_error("Error: addRow column index out of range");
+        if (cols[k] == i) {
+            d += vals[k];
+        } else {
+            colInd_.push_back(cols[k]);
+            val_.push_back(vals[k]);
+        }
+    }
+    diag_.push_back(d);
+    rowPtr_.push_back(colInd_.size());
+    ++nextRow_;
+
+    if (chunkBytes(diag_.size(), colInd_.size()) >= chunkBytes_)
+        flushChunk();
+}
+
+void OutOfCoreSparseMatrixCRSDouble::Writer::finish()
+{
+    if (finished_)
+        return;
+
+    while (nextRow_ < N_) {
+        diag_.push_back(0.0);
+        rowPtr_.push_back(colInd_.size());
+        ++nextRow_;
+        if (chunkBytes(diag_.size(), colInd_.size()) >= chunkBytes_)
+            flushChunk();
+    }
+    flushChunk();
+
+    const std::uint64_t indexOffset = offset_;
+    writeBytes(index_.data(), index_.size() * sizeof(std::uint64_t));
+
+    const std::uint64_t header[kHeaderWords] = {
+        kMagic, N_, nnz_, index_.size() / kIndexWords, indexOffset
+    };
+    if (std::fseek(f_, 0, SEEK_SET) != 0)
+        throw std::runtime_error("Error: Cannot seek in out-of-core matrix file");
+    writeBytes(header, sizeof(header));
+
+    const int rc = std::fclose(f_);
+    f_ = nullptr;
+    if (rc != 0)
+        throw std::runtime_error("Error: Failed to close out-of-core matrix file");
+    finished_ = true;
+}
+
+void OutOfCoreSparseMatrixCRSDouble::Writer::flushChunk()
+{
+    const std::size_t rows = diag_.size();
+    if (rows == 0)
+        return;
+
+    const std::size_t nnz = colInd_.size();
+    writeBytes(diag_.data(), rows * sizeof(double));
+    writeBytes(rowPtr_.data(), (rows + 1) * sizeof(std::uint64_t));
+    writeBytes(colInd_.data(), nnz * sizeof(std::uint64_t));
+    writeBytes(val_.data(), nnz * sizeof(double));
+
+    index_.push_back(chunkBegin_);
+    index_.push_back(rows);
+    index_.push_back(nnz);
+    index_.push_back(offset_ - chunkBytes(rows, nnz));
+
+    nnz_ += nnz;
+    chunkBegin_ += rows;
+    diag_.clear();
+    rowPtr_.assign(1, 0);
+    colInd_.clear();
+    val_.clear();
+}
+
+void OutOfCoreSparseMatrixCRSDouble::Writer::writeBytes(const void* p, std::size_t bytes)
+{
+    if (bytes > 0 && std::fwrite(p, 1, bytes, f_) != bytes)
+        throw std::runtime_error("Error: Failed to write out-of-core matrix file");
+    offset_ += bytes;
+}
+
+void OutOfCoreSparseMatrixCRSDouble::write(const std::string& path,
+                                           const SparseSquareMatrixCRSDouble& A,
+                                           std::size_t chunkBytes)
+{
+    const std::size_t N = A.size();
+    if (N > 0 && !A.isFinalized())
+        throw std::runtime_error("Error: SparseSquareMatrixCRSDouble not finalized()");
+
+    const std::size_t* rowPtr = A.rowPtrData();
+    const std::size_t* colInd = A.colIndData();
+    const double* val = A.valuesData();
+    const VectorDouble& diag = A.diagonal();
+
+    Writer w(path, N, chunkBytes);
+    std::vector<std::size_t> cols;
+    std::vector<double> vals;
+    for (std::size_t i = 0; i < N; ++i) {
+        cols.assign(colInd + rowPtr[i], colInd + rowPtr[i + 1]);
+        vals.assign(val + rowPtr[i], val + rowPtr[i + 1]);
+        cols.push_back(i);
+        vals.push_back(diag[i]);
+        w.addRow(i, cols.data(), vals.data(), cols.size());
+    }
+    w.finish();
+}
+
+// ---------------------------------------------------------------------------
+// Reader
+// ---------------------------------------------------------------------------
+
+OutOfCoreSparseMatrixCRSDouble::OutOfCoreSparseMatrixCRSDouble(const std::string& path)
+    : fd_(::open(path.c_str(), O_RDONLY)),
+      N_(0),
+      nnz_(0),
+      maxChunkBytes_(0),
+      pending_(nullptr),
+      pendingBuf_(nullptr),
+      readDone_(true),
+      stopReader_(false)
+{
+    if (fd_ < 0)
+        throw std::runtime_error("Error: Cannot open " + path);
+
+    try {
+        // every size below is checked against the file before anything is
+        // allocated or read from it
+        struct stat st;
+        if (::fstat(fd_, &st) != 0)
+            throw std::runtime_error("Error: Cannot stat " + path);
+        const std::uint64_t fileSize = static_cast<std::uint64_t>(st.st_size);
+
+        std::uint64_t header[kHeaderWords];
+        if (fileSize < sizeof(header))
+            throw std::runtime_error("Error: " + path + " is not a finished out-of-core CRS file");
+        Chunk all{0, 0, 0, 0, sizeof(header)};
+        readChunk(all, reinterpret_cast<char*>(header));
+        if (header[0] != kMagic)
+            throw std::runtime_error("Error: " + path + " is not a finished out-of-core CRS file");
+
+        const std::uint64_t indexOffset = header[4];
+        const std::uint64_t indexEntryBytes = kIndexWords * sizeof(std::uint64_t);
+        if (indexOffset < sizeof(header) || indexOffset > fileSize
+            || header[3] > (fileSize - indexOffset) / indexEntryBytes)
+            throw std::runtime_error("Error: Corrupt chunk index in " + path);
+        const std::size_t numChunks = header[3];
+
+        // each row and entry takes at least 8 bytes on disk
+        if (header[1] > fileSize / sizeof(double) || header[2] > fileSize / sizeof(double))
+            throw std::runtime_error("Error: Corrupt header in " + path);
+        N_ = header[1];
+        nnz_ = header[2];
+
+        std::vector<std::uint64_t> index(numChunks * kIndexWords);
+        Chunk idx{0, 0, 0, indexOffset, numChunks * indexEntryBytes};
+        readChunk(idx, reinterpret_cast<char*>(index.data()));
+
+        std::size_t row = 0, nnz = 0;
+        chunks_.reserve(numChunks);
+        for (std::size_t k = 0; k < numChunks; ++k) {
+            const std::uint64_t* e = &index[k * kIndexWords];
+            if (e[0] != row || e[1] > N_ - row || e[2] > nnz_ - nnz)
+                throw std::runtime_error("Error: Corrupt chunk index in " + path);
+
+            Chunk c;
+            c.rowBegin = e[0];
+            c.rows = e[1];
+            c.nnz = e[2];
+            c.offset = e[3];
+            if (!checkedChunkBytes(c.rows, c.nnz, c.bytes) || c.offset < sizeof(header)
+                || !fitsInFile(c.offset, c.bytes, fileSize))
+                throw std::runtime_error("Error: Corrupt chunk index in " + path);
+            row += c.rows;
+            nnz += c.nnz;
+            maxChunkBytes_ = std::max(maxChunkBytes_, c.bytes);
+            chunks_.push_back(c);
+        }
+        if (row != N_ || nnz != nnz_)
+            throw std::runtime_error("Error: Corrupt chunk index in " + path);
+    } catch (...) {
+        ::close(fd_);
+        throw;
+    }
+
+#ifdef POSIX_FADV_SEQUENTIAL
+    ::posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    if (chunks_.size() > 1)
+        reader_ = std::thread(&OutOfCoreSparseMatrixCRSDouble::prefetchLoop, this);
+}
+
+OutOfCoreSparseMatrixCRSDouble::~OutOfCoreSparseMatrixCRSDouble()
+{
+    if (reader_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(readM_);
+            stopReader_ = true;
+        }
+        readCv_.notify_all();
+        reader_.join();
+    }
+    ::close(fd_);
+}
+
+std::size_t OutOfCoreSparseMatrixCRSDouble::size() const noexcept
+{
+    return N_;
+}
+
+void OutOfCoreSparseMatrixCRSDouble::readChunk(const Chunk& c, char* buf) const
+{
+    std::size_t done = 0;
+    while (done < c.bytes) {
+        const ssize_t r = ::pread(fd_, buf + done, c.bytes - done,
+                                  static_cast<off_t>(c.offset + done));
+        if (r < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::runtime_error("Error: Read failed on out-of-core matrix file");
+        }
+        if (r == 0)
+            throw std::runtime_error("Error: Out-of-core matrix file is truncated");
+        done += static_cast<std::size_t>(r);
+    }
+}
+
+void OutOfCoreSparseMatrixCRSDouble::adviseChunk(const Chunk& c) const
+{
+#ifdef POSIX_FADV_WILLNEED
+    ::posix_fadvise(fd_, static_cast<off_t>(c.offset), static_cast<off_t>(c.bytes),
+                    POSIX_FADV_WILLNEED);
+#else
+    (void)c;
+#endif
+}
+
+void OutOfCoreSparseMatrixCRSDouble::checkChunk(const Chunk& c, const char* buf) const
+{
+    const std::uint64_t* rowPtr = reinterpret_cast<const std::uint64_t*>(buf + c.rows * sizeof(double));
+    const std::uint64_t* colInd = rowPtr + c.rows + 1;
+
+    bool ok = rowPtr[0] == 0 && rowPtr[c.rows] == c.nnz;
+    for (std::size_t i = 0; ok && i < c.rows; ++i)
+        ok = rowPtr[i] <= rowPtr[i + 1];
+    for (std::size_t p = 0; ok && p < c.nnz; ++p)
+        ok = colInd[p] < N_;
+    if (!ok)
+        throw std::runtime_error("Error: Corrupt chunk at row " + std::to_string(c.rowBegin)
+                                 + " in out-of-core matrix file");
+}
+
+void OutOfCoreSparseMatrixCRSDouble::prefetchLoop()
+{
+    std::unique_lock<std::mutex> lock(readM_);
+    for (;;) {
+        readCv_.wait(lock, [&] { return stopReader_ || pending_; });
+        if (stopReader_)
+            return;
+
+        const Chunk* c = pending_;
+        char* buf = pendingBuf_;
+        lock.unlock();
+        std::exception_ptr err;
+        try {
+            readChunk(*c, buf);
+        } catch (...) {
+            err = std::current_exception();
+        }
+        lock.lock();
+
+        pending_ = nullptr;
+        readError_ = err;
+        readDone_ = true;
+        readCv_.notify_all();
+    }
+}
+
+void OutOfCoreSparseMatrixCRSDouble::startRead(const Chunk& c, char* buf) const
+{
+    {
+        std::lock_guard<std::mutex> lock(readM_);
+        pending_ = &c;
+        pendingBuf_ = buf;
+        readDone_ = false;
+        readError_ = nullptr;
+    }
+    readCv_.notify_all();
+}
+
+void OutOfCoreSparseMatrixCRSDouble::waitRead() const
+{
+    std::unique_lock<std::mutex> lock(readM_);
+    readCv_.wait(lock, [&] { return readDone_; });
+    if (readError_)
+        std::rethrow_exception(readError_);
+}
+
+void OutOfCoreSparseMatrixCRSDouble::apply(const VectorDouble& x, VectorDouble& y) const
+{
+    if (x.size() != N_ || y.size() != N_)
+        throw std::runtime_error("Error: Dimension mismatch in out-of-core A*x");
+    if (chunks_.empty())
+        return;
+
+    std::lock_guard<std::mutex> applyLock(applyM_);
+    if (!buffers_[0]) {
+        buffers_[0].reset(new char[maxChunkBytes_]);
+        buffers_[1].reset(new char[maxChunkBytes_]);
+    }
+    const double* xd = x.data();
+    double* yd = y.data();
+
+    std::size_t cur = 0;
+    readChunk(chunks_[0], buffers_[0].get());
+    if (chunks_.size() > 1)
+        adviseChunk(chunks_[1]);
+
+    for (std::size_t k = 0; k < chunks_.size(); ++k) {
+        const bool prefetch = k + 1 < chunks_.size();
+        if (prefetch) {
+            startRead(chunks_[k + 1], buffers_[1 - cur].get());
+            if (k + 2 < chunks_.size())
+                adviseChunk(chunks_[k + 2]);
+        }
+
+        try {
+            const Chunk& c = chunks_[k];
+            const char* buf = buffers_[cur].get();
+            checkChunk(c, buf);
+
+            const double* diag = reinterpret_cast<const double*>(buf);
+            const std::uint64_t* rowPtr = reinterpret_cast<const std::uint64_t*>(diag + c.rows);
+            const std::uint64_t* colInd = rowPtr + c.rows + 1;
+            const double* val = reinterpret_cast<const double*>(colInd + c.nnz);
+            const double* xc = xd + c.rowBegin;
+            double* yc = yd + c.rowBegin;
+
+            parallelFor(c.rows, 256, [&](std::size_t i0, std::size_t i1) {
+                for (std::size_t i = i0; i < i1; ++i) {
+                    double sum = diag[i] * xc[i];
+                    for (std::uint64_t p = rowPtr[i]; p < rowPtr[i + 1]; ++p)
+                        sum += val[p] * xd[colInd[p]];
+                    yc[i] = sum;
+                }
+            });
+        } catch (...) {
+            // leave no read in flight into the buffers
+            if (prefetch) {
+                std::unique_lock<std::mutex> lock(readM_);
+                readCv_.wait(lock, [&] { return readDone_; });
+            }
+            throw;
+        }
+
+        if (prefetch)
+            waitRead();
+        cur = 1 - cur;
+    }
+}
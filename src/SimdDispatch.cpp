@@ -0,0 +1,496 @@
+#include "SimdDispatch.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define LA_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// Scalar reference kernels, also used for the remainder loops
+// ---------------------------------------------------------------------------
+
+void addScalar(const double* a, const double* b, double* out, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+        out[i] = a[i] + b[i];
+}
+
+void subScalar(const double* a, const double* b, double* out, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+        out[i] = a[i] - b[i];
+}
+
+void scaleScalar(const double* a, double s, double* out, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+        out[i] = a[i] * s;
+}
+
+void axpyScalar(double alpha, const double* x, double* y, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i)
+        y[i] += alpha * x[i];
+}
+
+double dotScalar(const double* a, const double* b, std::size_t n)
+{
+    double sum = 0.0;
+    for (std::size_t i = 0; i < n; ++i)
+        sum += a[i] * b[i];
+    return sum;
+}
+
+// NaN is sticky: once seen it is the result, at every level
+double maxAbsScalar(const double* a, std::size_t n)
+{
+    double maxVal = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        const double v = std::abs(a[i]);
+        if (std::isnan(v))
+            return v;
+        maxVal = std::max(maxVal, v);
+    }
+    return maxVal;
+}
+
+// combine a vector-lane maximum with the scalar tail, keeping NaN sticky
+inline double maxAbsCombine(bool sawNaN, double lanes, double tail)
+{
+    if (sawNaN)
+        return std::numeric_limits<double>::quiet_NaN();
+    if (std::isnan(tail))
+        return tail;
+    return std::max(lanes, tail);
+}
+
+void spmvCRSScalar(std::size_t i0, std::size_t i1, const double* diag,
+                   const std::size_t* rowPtr, const std::size_t* colInd,
+                   const double* val, const double* x, double* y)
+{
+    for (std::size_t i = i0; i < i1; ++i) {
+        double sum = diag[i] * x[i];
+        for (std::size_t p = rowPtr[i]; p < rowPtr[i + 1]; ++p)
+            sum += val[p] * x[colInd[p]];
+        y[i] = sum;
+    }
+}
+
+#ifdef LA_SIMD_X86
+
+// ---------------------------------------------------------------------------
+// SSE2: 2 doubles per register
+// ---------------------------------------------------------------------------
+
+#define LA_TARGET_SSE2 __attribute__((target("sse2")))
+
+LA_TARGET_SSE2 inline double hsum128(__m128d v)
+{
+    return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+}
+
+LA_TARGET_SSE2 void addSSE2(const double* a, const double* b, double* out, std::size_t n)
+{
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+        _mm_storeu_pd(out + i, _mm_add_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+    addScalar(a + i, b + i, out + i, n - i);
+}
+
+LA_TARGET_SSE2 void subSSE2(const double* a, const double* b, double* out, std::size_t n)
+{
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+        _mm_storeu_pd(out + i, _mm_sub_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+    subScalar(a + i, b + i, out + i, n - i);
+}
+
+LA_TARGET_SSE2 void scaleSSE2(const double* a, double s, double* out, std::size_t n)
+{
+    const __m128d sv = _mm_set1_pd(s);
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+        _mm_storeu_pd(out + i, _mm_mul_pd(_mm_loadu_pd(a + i), sv));
+    scaleScalar(a + i, s, out + i, n - i);
+}
+
+LA_TARGET_SSE2 void axpySSE2(double alpha, const double* x, double* y, std::size_t n)
+{
+    const __m128d av = _mm_set1_pd(alpha);
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+        _mm_storeu_pd(y + i, _mm_add_pd(_mm_loadu_pd(y + i),
+                                        _mm_mul_pd(av, _mm_loadu_pd(x + i))));
+    axpyScalar(alpha, x + i, y + i, n - i);
+}
+
+LA_TARGET_SSE2 double dotSSE2(const double* a, const double* b, std::size_t n)
+{
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2)));
+    }
+    return hsum128(_mm_add_pd(acc0, acc1)) + dotScalar(a + i, b + i, n - i);
+}
+
+LA_TARGET_SSE2 double maxAbsSSE2(const double* a, std::size_t n)
+{
+    const __m128d mask = _mm_castsi128_pd(_mm_set1_epi64x(0x7fffffffffffffffLL));
+    __m128d m = _mm_setzero_pd();
+    __m128d nan = _mm_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        const __m128d v = _mm_and_pd(_mm_loadu_pd(a + i), mask);
+        nan = _mm_or_pd(nan, _mm_cmpunord_pd(v, v));
+        m = _mm_max_pd(m, v);
+    }
+    const double hi = std::max(_mm_cvtsd_f64(m), _mm_cvtsd_f64(_mm_unpackhi_pd(m, m)));
+    return maxAbsCombine(_mm_movemask_pd(nan) != 0, hi, maxAbsScalar(a + i, n - i));
+}
+
+// ---------------------------------------------------------------------------
+// AVX2 + FMA: 4 doubles per register, hardware gather for SpMV
+// ---------------------------------------------------------------------------
+
+#define LA_TARGET_AVX2 __attribute__((target("avx2,fma")))
+
+LA_TARGET_AVX2 inline double hsum256(__m256d v)
+{
+    __m128d lo = _mm256_castpd256_pd128(v);
+    lo = _mm_add_pd(lo, _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+}
+
+LA_TARGET_AVX2 void addAVX2(const double* a, const double* b, double* out, std::size_t n)
+{
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    addScalar(a + i, b + i, out + i, n - i);
+}
+
+LA_TARGET_AVX2 void subAVX2(const double* a, const double* b, double* out, std::size_t n)
+{
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(out + i, _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    subScalar(a + i, b + i, out + i, n - i);
+}
+
+LA_TARGET_AVX2 void scaleAVX2(const double* a, double s, double* out, std::size_t n)
+{
+    const __m256d sv = _mm256_set1_pd(s);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_loadu_pd(a + i), sv));
+    scaleScalar(a + i, s, out + i, n - i);
+}
+
+LA_TARGET_AVX2 void axpyAVX2(double alpha, const double* x, double* y, std::size_t n)
+{
+    const __m256d av = _mm256_set1_pd(alpha);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(y + i, _mm256_fmadd_pd(av, _mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+    axpyScalar(alpha, x + i, y + i, n - i);
+}
+
+LA_TARGET_AVX2 double dotAVX2(const double* a, const double* b, std::size_t n)
+{
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), acc0);
+        acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), acc1);
+    }
+    for (; i + 4 <= n; i += 4)
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), acc0);
+    return hsum256(_mm256_add_pd(acc0, acc1)) + dotScalar(a + i, b + i, n - i);
+}
+
+LA_TARGET_AVX2 double maxAbsAVX2(const double* a, std::size_t n)
+{
+    const __m256d mask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+    __m256d m = _mm256_setzero_pd();
+    __m256d nan = _mm256_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256d v = _mm256_and_pd(_mm256_loadu_pd(a + i), mask);
+        nan = _mm256_or_pd(nan, _mm256_cmp_pd(v, v, _CMP_UNORD_Q));
+        m = _mm256_max_pd(m, v);
+    }
+    __m128d h = _mm_max_pd(_mm256_castpd256_pd128(m), _mm256_extractf128_pd(m, 1));
+    const double hi = std::max(_mm_cvtsd_f64(h), _mm_cvtsd_f64(_mm_unpackhi_pd(h, h)));
+    return maxAbsCombine(_mm256_movemask_pd(nan) != 0, hi, maxAbsScalar(a + i, n - i));
+}
+
+LA_TARGET_AVX2 void spmvCRSAVX2(std::size_t i0, std::size_t i1, const double* diag,
+                                const std::size_t* rowPtr, const std::size_t* colInd,
+                                const double* val, const double* x, double* y)
+{
+    for (std::size_t i = i0; i < i1; ++i) {
+        const std::size_t end = rowPtr[i + 1];
+        std::size_t p = rowPtr[i];
+
+        __m256d acc = _mm256_setzero_pd();
+        for (; p + 4 <= end; p += 4) {
+            const __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(colInd + p));
+            acc = _mm256_fmadd_pd(_mm256_loadu_pd(val + p), _mm256_i64gather_pd(x, idx, 8), acc);
+        }
+
+        double sum = diag[i] * x[i] + hsum256(acc);
+        for (; p < end; ++p)
+            sum += val[p] * x[colInd[p]];
+        y[i] = sum;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// AVX-512F: 8 doubles per register, masked tails
+// ---------------------------------------------------------------------------
+
+#define LA_TARGET_AVX512 __attribute__((target("avx512f")))
+
+// GCC 12's avx512fintrin.h self-initialises its "undefined" operands, which
+// -Wuninitialized reports at every inlined call site
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+LA_TARGET_AVX512 inline __mmask8 tailMask(std::size_t rem)
+{
+    return static_cast<__mmask8>((1u << rem) - 1u);
+}
+
+LA_TARGET_AVX512 void addAVX512(const double* a, const double* b, double* out, std::size_t n)
+{
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm512_storeu_pd(out + i, _mm512_add_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+    if (i < n) {
+        const __mmask8 k = tailMask(n - i);
+        _mm512_mask_storeu_pd(out + i, k, _mm512_add_pd(_mm512_maskz_loadu_pd(k, a + i),
+                                                        _mm512_maskz_loadu_pd(k, b + i)));
+    }
+}
+
+LA_TARGET_AVX512 void subAVX512(const double* a, const double* b, double* out, std::size_t n)
+{
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm512_storeu_pd(out + i, _mm512_sub_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+    if (i < n) {
+        const __mmask8 k = tailMask(n - i);
+        _mm512_mask_storeu_pd(out + i, k, _mm512_sub_pd(_mm512_maskz_loadu_pd(k, a + i),
+                                                        _mm512_maskz_loadu_pd(k, b + i)));
+    }
+}
+
+LA_TARGET_AVX512 void scaleAVX512(const double* a, double s, double* out, std::size_t n)
+{
+    const __m512d sv = _mm512_set1_pd(s);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm512_storeu_pd(out + i, _mm512_mul_pd(_mm512_loadu_pd(a + i), sv));
+    if (i < n) {
+        const __mmask8 k = tailMask(n - i);
+        _mm512_mask_storeu_pd(out + i, k, _mm512_mul_pd(_mm512_maskz_loadu_pd(k, a + i), sv));
+    }
+}
+
+LA_TARGET_AVX512 void axpyAVX512(double alpha, const double* x, double* y, std::size_t n)
+{
+    const __m512d av = _mm512_set1_pd(alpha);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm512_storeu_pd(y + i, _mm512_fmadd_pd(av, _mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+    if (i < n) {
+        const __mmask8 k = tailMask(n - i);
+        _mm512_mask_storeu_pd(y + i, k, _mm512_fmadd_pd(av, _mm512_maskz_loadu_pd(k, x + i),
+                                                        _mm512_maskz_loadu_pd(k, y + i)));
+    }
+}
+
+LA_TARGET_AVX512 double dotAVX512(const double* a, const double* b, std::size_t n)
+{
+    __m512d acc0 = _mm512_setzero_pd();
+    __m512d acc1 = _mm512_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), acc0);
+        acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 8), _mm512_loadu_pd(b + i + 8), acc1);
+    }
+    for (; i + 8 <= n; i += 8)
+        acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), acc0);
+    if (i < n) {
+        const __mmask8 k = tailMask(n - i);
+        acc1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(k, a + i), _mm512_maskz_loadu_pd(k, b + i), acc1);
+    }
+    return _mm512_reduce_add_pd(_mm512_add_pd(acc0, acc1));
+}
+
+LA_TARGET_AVX512 double maxAbsAVX512(const double* a, std::size_t n)
+{
+    __m512d m = _mm512_setzero_pd();
+    __mmask8 nan = 0;
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m512d v = _mm512_abs_pd(_mm512_loadu_pd(a + i));
+        nan |= _mm512_cmp_pd_mask(v, v, _CMP_UNORD_Q);
+        m = _mm512_max_pd(m, v);
+    }
+    if (i < n) {
+        const __m512d v = _mm512_abs_pd(_mm512_maskz_loadu_pd(tailMask(n - i), a + i));
+        nan |= _mm512_cmp_pd_mask(v, v, _CMP_UNORD_Q);
+        m = _mm512_max_pd(m, v);
+    }
+    return maxAbsCombine(nan != 0, _mm512_reduce_max_pd(m), 0.0);
+}
+
+LA_TARGET_AVX512 void spmvCRSAVX512(std::size_t i0, std::size_t i1, const double* diag,
+                                    const std::size_t* rowPtr, const std::size_t* colInd,
+                                    const double* val, const double* x, double* y)
+{
+    for (std::size_t i = i0; i < i1; ++i) {
+        const std::size_t end = rowPtr[i + 1];
+        std::size_t p = rowPtr[i];
+
+        __m512d acc = _mm512_setzero_pd();
+        for (; p + 8 <= end; p += 8) {
+            const __m512i idx = _mm512_loadu_si512(colInd + p);
+            acc = _mm512_fmadd_pd(_mm512_loadu_pd(val + p), _mm512_i64gather_pd(idx, x, 8), acc);
+        }
+        if (p < end) {
+            const __mmask8 k = tailMask(end - p);
+            const __m512i idx = _mm512_maskz_loadu_epi64(k, colInd + p);
+            const __m512d xv = _mm512_mask_i64gather_pd(_mm512_setzero_pd(), k, idx, x, 8);
+            acc = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(k, val + p), xv, acc);
+        }
+
+        y[i] = diag[i] * x[i] + _mm512_reduce_add_pd(acc);
+    }
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif // LA_SIMD_X86
+
+const SimdKernels kScalarKernels = {
+    addScalar, subScalar, scaleScalar, axpyScalar, dotScalar, maxAbsScalar, spmvCRSScalar
+};
+
+#ifdef LA_SIMD_X86
+// no profitable SSE2 gather, the scalar SpMV is already SSE2 code on x86-64
+const SimdKernels kSSE2Kernels = {
+    addSSE2, subSSE2, scaleSSE2, axpySSE2, dotSSE2, maxAbsSSE2, spmvCRSScalar
+};
+const SimdKernels kAVX2Kernels = {
+    addAVX2, subAVX2, scaleAVX2, axpyAVX2, dotAVX2, maxAbsAVX2, spmvCRSAVX2
+};
+const SimdKernels kAVX512Kernels = {
+    addAVX512, subAVX512, scaleAVX512, axpyAVX512, dotAVX512, maxAbsAVX512, spmvCRSAVX512
+};
+#endif
+
+SimdLevel detectLevel()
+{
+#ifdef LA_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return SimdLevel::AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return SimdLevel::SSE2;
+#endif
+    return SimdLevel::Scalar;
+}
+
+SimdLevel selectLevel()
+{
+    const SimdLevel supported = simdLevelSupported();
+
+    const char* env = std::getenv("LA_SIMD_LEVEL");
+    if (!env)
+        return supported;
+
+    std::string req(env);
+    std::transform(req.begin(), req.end(), req.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    SimdLevel forced;
+    if (req == "scalar")
+        forced = SimdLevel::Scalar;
+    else if (req == "sse2")
+        forced = SimdLevel::SSE2;
+    else if (req == "avx2")
+        forced = SimdLevel::AVX2;
+    else if (req == "avx512")
+        forced = SimdLevel::AVX512;
+    else
+        return supported; // unknown value: keep the detected level
+
+    return std::min(forced, supported);
+}
+
+} // namespace
+
+SimdLevel simdLevelSupported()
+{
+    static const SimdLevel level = detectLevel();
+    return level;
+}
+
+SimdLevel simdLevel()
+{
+    static const SimdLevel level = selectLevel();
+    return level;
+}
+
+const char* simdLevelName(SimdLevel level)
+{
+    switch (level) {
+    case SimdLevel::Scalar: return "scalar";
+    case SimdLevel::SSE2:   return "sse2";
+    case SimdLevel::AVX2:   return "avx2";
+    case SimdLevel::AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+const SimdKernels& simdKernels(SimdLevel level)
+{
+    level = std::min(level, simdLevelSupported());
+
+#ifdef LA_SIMD_X86
+    switch (level) {
+    case SimdLevel::AVX512: return kAVX512Kernels;
+    case SimdLevel::AVX2:   return kAVX2Kernels;
+    case SimdLevel::SSE2:   return kSSE2Kernels;
+    case SimdLevel::Scalar: break;
+    }
+#endif
+    return kScalarKernels;
+}
+
+const SimdKernels& simdKernels()
+{
+    static const SimdKernels& kernels = simdKernels(simdLevel());
+    return kernels;
+}
@@ -0,0 +1,421 @@
+#include "SolveService.hpp"
+#include "ComputePool.hpp"
+#include "DenseFactorizationDouble.hpp"
+#include "KrylovSolvers.hpp"
+#include "LinearOperatorDouble.hpp"
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// non-owning operators over the shared matrices
+class DenseRefOperator : public LinearOperatorDouble {
+public:
+    explicit DenseRefOperator(const DenseSquareMatrixDouble& A) : A_(A) {}
+    std::size_t size() const noexcept override { return A_.size(); }
+    void apply(const VectorDouble& x, VectorDouble& y) const override { y = A_ * x; }
+
+private:
+    const DenseSquareMatrixDouble& A_;
+};
+
+class CRSRefOperator : public LinearOperatorDouble {
+public:
+    explicit CRSRefOperator(const SparseSquareMatrixCRSDouble& A) : A_(A) {}
+    std::size_t size() const noexcept override { return A_.size(); }
+    void apply(const VectorDouble& x, VectorDouble& y) const override { A_.multiply(x, y); }
+
+private:
+    const SparseSquareMatrixCRSDouble& A_;
+};
+
+// z = D^{-1} r; zero diagonal entries are treated as 1
+class JacobiOperator : public LinearOperatorDouble {
+public:
+    explicit JacobiOperator(VectorDouble&& diag) : invDiag_(std::move(diag))
+    {
+        for (std::size_t i = 0; i < invDiag_.size(); ++i)
+            invDiag_[i] = invDiag_[i] != 0.0 ? 1.0 / invDiag_[i] : 1.0;
+    }
+    std::size_t size() const noexcept override { return invDiag_.size(); }
+    void apply(const VectorDouble& x, VectorDouble& y) const override
+    {
+        for (std::size_t i = 0; i < invDiag_.size(); ++i)
+            y[i] = invDiag_[i] * x[i];
+    }
+
+private:
+    VectorDouble invDiag_;
+};
+
+template <class T>
+using Slot = std::shared_future<std::shared_ptr<const T>>;
+
+// Returns the object in `slot`, building it on this thread if no other job
+// has claimed it. `m` is held only to claim the slot, never while building
+// or waiting, so jobs for other slots of the same matrix are not blocked.
+// A failed build stays in the slot (e.g. Cholesky of a matrix that is not
+// SPD); a stopped one is released for the next job to retry.
+template <class T, class Build>
+std::shared_ptr<const T> getOrBuild(std::mutex& m, Slot<T>& slot, bool& reused, Build build)
+{
+    for (;;) {
+        std::promise<std::shared_ptr<const T>> promise;
+        Slot<T> f;
+        bool owner = false;
+        {
+            std::lock_guard<std::mutex> lock(m);
+            if (!slot.valid()) {
+                slot = promise.get_future().share();
+                owner = true;
+            }
+            f = slot;
+        }
+
+        if (!owner) {
+            try {
+                reused = true;
+                return f.get();
+            } catch (const FactorizationStopped&) {
+                continue;  // the building job was stopped, not this one
+            }
+        }
+
+        reused = false;
+        try {
+            std::shared_ptr<const T> obj = build();
+            promise.set_value(obj);
+            return obj;
+        } catch (const FactorizationStopped&) {
+            {
+                std::lock_guard<std::mutex> lock(m);
+                slot = Slot<T>();
+            }
+            promise.set_exception(std::current_exception());
+            throw;
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+    }
+}
+
+SolveMethod methodFor(SolverKind s)
+{
+    switch (s) {
+    case SolverKind::LU:       return SolveMethod::LU;
+    case SolverKind::Cholesky: return SolveMethod::Cholesky;
+    case SolverKind::CG:       return SolveMethod::CG;
+    case SolverKind::GMRES:    return SolveMethod::GMRES;
+    }
+    return SolveMethod::GMRES;
+}
+
+} // namespace
+
+struct SolveService::MatrixCache {
+    std::weak_ptr<const void> owner;
+
+    // claims the lazy builds below; the built objects are immutable
+    std::mutex m;
+    Slot<MatrixAnalysis> analysis;
+    Slot<DenseLUDouble> lu;
+    Slot<DenseCholeskyDouble> chol;
+    Slot<JacobiOperator> jacobi;
+};
+
+struct SolveService::Job {
+    std::shared_ptr<const DenseSquareMatrixDouble> dense;   // exactly one set
+    std::shared_ptr<const SparseSquareMatrixCRSDouble> sparse;
+    std::shared_ptr<MatrixCache> cache;
+
+    VectorDouble b{0};
+    SolveOptions opts;
+    std::shared_ptr<std::atomic<bool>> cancelled;
+    std::promise<SolveResult> promise;
+};
+
+void SolveService::Handle::cancel()
+{
+    if (cancelled_)
+        cancelled_->store(true);
+}
+
+SolveService::SolveService(std::size_t smallWorkers, std::size_t largeWork)
+    : largeWork_(largeWork), stop_(false)
+{
+    if (smallWorkers == 0) {
+        const unsigned hw = std::thread::hardware_concurrency();
+        smallWorkers = hw > 0 ? hw : 1;
+    }
+
+    workers_.emplace_back(&SolveService::workerLoop, this, true);
+    for (std::size_t t = 0; t < smallWorkers; ++t)
+        workers_.emplace_back(&SolveService::workerLoop, this, false);
+}
+
+SolveService::~SolveService()
+{
+    std::deque<std::unique_ptr<Job>> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        stop_ = true;
+        for (auto& j : small_)
+            pending.push_back(std::move(j));
+        for (auto& j : large_)
+            pending.push_back(std::move(j));
+        small_.clear();
+        large_.clear();
+    }
+    wake_.notify_all();
+
+    for (auto& j : pending) {
+        SolveResult r;
+        r.status = SolveStatus::Cancelled;
+        j->promise.set_value(std::move(r));
+    }
+    for (std::thread& w : workers_)
+        w.join();
+}
+
+SolveService::Handle SolveService::submit(std::shared_ptr<const DenseSquareMatrixDouble> A,
+                                          VectorDouble b, const SolveOptions& opts)
+{
+    if (!A || b.size() != A->size())
+        throw std::runtime_error("Error: Dimension mismatch in SolveService::submit");
+
+    std::unique_ptr<Job> job(new Job);
+    job->cache = cacheFor(A);
+    job->dense = std::move(A);
+    job->b = std::move(b);
+    job->opts = opts;
+    const std::size_t n = job->dense->size();
+    return enqueue(std::move(job), n * n);
+}
+
+SolveService::Handle SolveService::submit(std::shared_ptr<const SparseSquareMatrixCRSDouble> A,
+                                          VectorDouble b, const SolveOptions& opts)
+{
+    if (!A || b.size() != A->size())
+        throw std::runtime_error("Error: Dimension mismatch in SolveService::submit");
+
+    std::unique_ptr<Job> job(new Job);
+    job->cache = cacheFor(A);
+    job->sparse = std::move(A);
+    job->b = std::move(b);
+    job->opts = opts;
+    const std::size_t work = job->sparse->nnz() + job->sparse->size();
+    return enqueue(std::move(job), work);
+}
+
+SolveService::Handle SolveService::enqueue(std::unique_ptr<Job> job, std::size_t work)
+{
+    Handle h;
+    h.cancelled_ = std::make_shared<std::atomic<bool>>(false);
+    h.future_ = job->promise.get_future();
+    job->cancelled = h.cancelled_;
+
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        if (work >= largeWork_)
+            large_.push_back(std::move(job));
+        else
+            small_.push_back(std::move(job));
+    }
+    wake_.notify_all();
+    return h;
+}
+
+std::shared_ptr<SolveService::MatrixCache>
+SolveService::cacheFor(const std::shared_ptr<const void>& A)
+{
+    std::lock_guard<std::mutex> lock(cacheM_);
+    purgeExpired();
+
+    std::shared_ptr<MatrixCache>& entry = cache_[A.get()];
+    if (!entry) {
+        entry = std::make_shared<MatrixCache>();
+        entry->owner = A;
+    }
+    return entry;
+}
+
+std::size_t SolveService::cachedMatrices()
+{
+    std::lock_guard<std::mutex> lock(cacheM_);
+    purgeExpired();
+    return cache_.size();
+}
+
+// cacheM_ held
+void SolveService::purgeExpired()
+{
+    for (auto it = cache_.begin(); it != cache_.end();) {
+        if (it->second->owner.expired())
+            it = cache_.erase(it);
+        else
+            ++it;
+    }
+}
+
+void SolveService::clearCache()
+{
+    std::lock_guard<std::mutex> lock(cacheM_);
+    cache_.clear();
+}
+
+void SolveService::workerLoop(bool large)
+{
+    // small jobs never take the pool
+    std::unique_ptr<ComputePool::SerialScope> serial;
+    if (!large)
+        serial.reset(new ComputePool::SerialScope());
+
+    std::deque<std::unique_ptr<Job>>& queue = large ? large_ : small_;
+    for (;;) {
+        std::unique_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(m_);
+            wake_.wait(lock, [&] { return stop_ || !queue.empty(); });
+            if (queue.empty())
+                return;
+            job = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        std::promise<SolveResult> promise(std::move(job->promise));
+        SolveResult res;
+        std::exception_ptr err;
+        try {
+            res = run(*job);
+        } catch (...) {
+            err = std::current_exception();
+        }
+
+        // drop the job's matrix references, and with them the cache entry if
+        // the caller has let go of the matrix, before the caller can observe
+        // the result
+        job.reset();
+        {
+            std::lock_guard<std::mutex> lock(cacheM_);
+            purgeExpired();
+        }
+
+        if (err)
+            promise.set_exception(err);
+        else
+            promise.set_value(std::move(res));
+    }
+}
+
+SolveResult SolveService::run(Job& job)
+{
+    const SolveOptions& o = job.opts;
+    auto expired = [&] { return Clock::now() >= o.deadline; };
+    auto stopped = [&] { return job.cancelled->load() || expired(); };
+    auto stopStatus = [&] {
+        return job.cancelled->load() ? SolveStatus::Cancelled : SolveStatus::DeadlineExpired;
+    };
+
+    SolveResult res;
+    try {
+        if (stopped()) {
+            res.status = stopStatus();
+            return res;
+        }
+
+        MatrixCache& c = *job.cache;
+        const std::size_t n = job.b.size();
+
+        // resolve Auto with the same plan LinearSystemAuto uses; the storage
+        // stays as submitted, direct solves factor a dense copy of a CRS matrix
+        SolveMethod method = o.method;
+        if (method == SolveMethod::Auto) {
+            bool shared = false;
+            std::shared_ptr<const MatrixAnalysis> a =
+                getOrBuild(c.m, c.analysis, shared, [&] {
+                    return std::make_shared<const MatrixAnalysis>(
+                        job.dense ? MatrixAnalysis::analyze(*job.dense)
+                                  : MatrixAnalysis::analyze(*job.sparse));
+                });
+            method = methodFor(selectSolverPlan(*a).solver);
+        }
+
+        if (method == SolveMethod::LU || method == SolveMethod::Cholesky) {
+            std::shared_ptr<const DenseLUDouble> lu;
+            std::shared_ptr<const DenseCholeskyDouble> chol;
+            if (method == SolveMethod::Cholesky) {
+                try {
+                    chol = getOrBuild(c.m, c.chol, res.reused, [&] {
+                        return job.dense
+                            ? std::make_shared<const DenseCholeskyDouble>(*job.dense, stopped)
+                            : std::make_shared<const DenseCholeskyDouble>(job.sparse->toDense(), stopped);
+                    });
+                } catch (const FactorizationStopped&) {
+                    throw;
+                } catch (const std::runtime_error&) {
+                    // not SPD, fall back to LU; the failure stays cached
+                }
+            }
+            if (!chol)
+                lu = getOrBuild(c.m, c.lu, res.reused, [&] {
+                    return job.dense
+                        ? std::make_shared<const DenseLUDouble>(*job.dense, stopped)
+                        : std::make_shared<const DenseLUDouble>(job.sparse->toDense(), stopped);
+                });
+
+            if (stopped()) {
+                res.status = stopStatus();
+                return res;
+            }
+            res.solver = chol ? SolverKind::Cholesky : SolverKind::LU;
+            res.x = chol ? chol->solve(job.b) : lu->solve(job.b);
+            return res;
+        }
+
+        // iterative paths
+        std::unique_ptr<LinearOperatorDouble> op;
+        if (job.dense)
+            op.reset(new DenseRefOperator(*job.dense));
+        else
+            op.reset(new CRSRefOperator(*job.sparse));
+        const LinearOperatorDouble& A = *op;
+        VectorDouble x(n);
+
+        if (method == SolveMethod::CG) {
+            std::shared_ptr<const JacobiOperator> M =
+                getOrBuild(c.m, c.jacobi, res.reused, [&] {
+                    VectorDouble d(n);
+                    for (std::size_t i = 0; i < n; ++i)
+                        d[i] = job.dense ? (*job.dense)(i, i) : job.sparse->diagonal()[i];
+                    return std::make_shared<const JacobiOperator>(std::move(d));
+                });
+            try {
+                res.solver = SolverKind::CG;
+                res.iterations = solvePCG(A, *M, job.b, x, o.relTol, o.maxIter, stopped);
+            } catch (const KrylovBreakdown&) {
+                if (o.method != SolveMethod::Auto)
+                    throw;
+                // CG breakdown on a matrix that only looked SPD
+                x = VectorDouble(n);
+                method = SolveMethod::GMRES;
+            }
+        }
+
+        if (method == SolveMethod::GMRES) {
+            res.solver = SolverKind::GMRES;
+            res.iterations = solveGMRES(A, job.b, x, o.relTol, o.maxIter, 30, stopped);
+        }
+
+        res.x = std::move(x);
+        return res;
+    } catch (const KrylovStopped&) {
+        SolveResult r;
+        r.status = stopStatus();
+        return r;
+    } catch (const FactorizationStopped&) {
+        SolveResult r;
+        r.status = stopStatus();
+        return r;
+    }
+}
@@ -0,0 +1,276 @@
+#include "SparseSquareMatrixBSRDouble.hpp"
+#include "ComputePool.hpp"
+#include "NumaMemory.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+// y += A * x for one B x B block; B is a compile-time constant so the
+// loops are fully unrolled and the inner sums vectorize
+template <std::size_t B>
+inline void blockMultAdd(const double* A, const double* x, double* y)
+{
+    for (std::size_t r = 0; r < B; ++r) {
+        double sum = 0.0;
+        for (std::size_t c = 0; c < B; ++c)
+            sum += A[r * B + c] * x[c];
+        y[r] += sum;
+    }
+}
+
+// Gauss-Jordan inverse with partial pivoting, returns false if singular
+template <std::size_t B>
+bool invertBlock(const double* A, double* Ainv)
+{
+    double M[B * B];
+    for (std::size_t k = 0; k < B * B; ++k) {
+        M[k] = A[k];
+        Ainv[k] = 0.0;
+    }
+    for (std::size_t r = 0; r < B; ++r)
+        Ainv[r * B + r] = 1.0;
+
+    for (std::size_t c = 0; c < B; ++c) {
+        std::size_t piv = c;
+        for (std::size_t r = c + 1; r < B; ++r)
+            if (std::abs(M[r * B + c]) > std::abs(M[piv * B + c]))
+                piv = r;
+
+        if (M[piv * B + c] == 0.0)
+            return false;
+
+        if (piv != c) {
+            for (std::size_t k = 0; k < B; ++k) {
+                std::swap(M[c * B + k], M[piv * B + k]);
+                std::swap(Ainv[c * B + k], Ainv[piv * B + k]);
+            }
+        }
+
+        const double inv = 1.0 / M[c * B + c];
+        for (std::size_t k = 0; k < B; ++k) {
+            M[c * B + k] *= inv;
+            Ainv[c * B + k] *= inv;
+        }
+
+        for (std::size_t r = 0; r < B; ++r) {
+            if (r == c) continue;
+            const double f = M[r * B + c];
+            if (f == 0.0) continue;
+            for (std::size_t k = 0; k < B; ++k) {
+                M[r * B + k] -= f * M[c * B + k];
+                Ainv[r * B + k] -= f * Ainv[c * B + k];
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+template <std::size_t B>
+SparseSquareMatrixBSRDouble<B>::SparseSquareMatrixBSRDouble(std::size_t Nb)
+    : Nb_(Nb), finalized_(false), diag_(Nb * B * B, 0.0), diagInvertible_(false)
+{}
+
+template <std::size_t B>
+std::size_t SparseSquareMatrixBSRDouble<B>::size() const noexcept { return Nb_ * B; }
+
+template <std::size_t B>
+std::size_t SparseSquareMatrixBSRDouble<B>::numBlockRows() const noexcept { return Nb_; }
+
+template <std::size_t B>
+std::size_t SparseSquareMatrixBSRDouble<B>::nnzBlocks() const noexcept { return colInd_.size(); }
+
+template <std::size_t B>
+std::size_t SparseSquareMatrixBSRDouble<B>::nnz() const noexcept { return val_.size() + diag_.size(); }
+
+template <std::size_t B>
+void SparseSquareMatrixBSRDouble<B>::addEntry(std::size_t i, std::size_t j, double val)
+{
+    if (finalized_)
+        throw std::runtime_error("Error: Cannot addEntry after finalize()");
+    if (i >= Nb_ * B || j >= Nb_ * B)
+        throw std::runtime_error("Error: addEntry index out of range");
+
+    entries_.push_back({i, j, val});
+}
+
+template <std::size_t B>
+void SparseSquareMatrixBSRDouble<B>::addBlock(std::size_t ib, std::size_t jb, const Block& blk)
+{
+    if (finalized_)
+        throw std::runtime_error("Error: Cannot addBlock after finalize()");
+    if (ib >= Nb_ || jb >= Nb_)
+        throw std::runtime_error("Error: addBlock index out of range");
+
+    blockEntries_.push_back({ib, jb, blk});
+}
+
+template <std::size_t B>
+void SparseSquareMatrixBSRDouble<B>::finalize()
+{
+    if (finalized_)
+        return;
+
+    std::fill(diag_.begin(), diag_.end(), 0.0);
+    rowPtr_.assign(Nb_ + 1, 0);
+    colInd_.clear();
+    val_.clear();
+
+    // both builder lists sorted by block (row, col), then merged
+    std::sort(entries_.begin(), entries_.end(),
+              [](const Triplet& a, const Triplet& b) {
+                  if (a.i / B != b.i / B) {
+                    return a.i / B < b.i / B;
+                  }
+                  return a.j / B < b.j / B;
+              });
+    std::sort(blockEntries_.begin(), blockEntries_.end(),
+              [](const BlockTriplet& a, const BlockTriplet& b) {
+                  if (a.ib != b.ib) {
+                    return a.ib < b.ib;
+                  }
+                  return a.jb < b.jb;
+              });
+
+    const std::size_t ns = entries_.size();
+    const std::size_t nb = blockEntries_.size();
+    auto scalarKey = [&](std::size_t k) {
+        return std::make_pair(entries_[k].i / B, entries_[k].j / B);
+    };
+    auto blockKey = [&](std::size_t k) {
+        return std::make_pair(blockEntries_[k].ib, blockEntries_[k].jb);
+    };
+
+    // visits every distinct block once, in order, with the ranges of
+    // scalar and block entries that land in it
+    auto forEachBlock = [&](auto&& fn) {
+        std::size_t ks = 0, kb = 0;
+        while (ks < ns || kb < nb) {
+            std::pair<std::size_t, std::size_t> key;
+            if (kb == nb || (ks < ns && scalarKey(ks) < blockKey(kb)))
+                key = scalarKey(ks);
+            else
+                key = blockKey(kb);
+
+            const std::size_t ks0 = ks, kb0 = kb;
+            while (ks < ns && scalarKey(ks) == key)
+                ++ks;
+            while (kb < nb && blockKey(kb) == key)
+                ++kb;
+            fn(key.first, key.second, ks0, ks, kb0, kb);
+        }
+    };
+
+    // First pass: count unique off-diagonal blocks per block row
+    forEachBlock([&](std::size_t ib, std::size_t jb, std::size_t, std::size_t,
+                     std::size_t, std::size_t) {
+        if (ib != jb)
+            rowPtr_[ib + 1] += 1;
+    });
+
+    for (std::size_t ib = 0; ib < Nb_; ++ib)
+        rowPtr_[ib + 1] += rowPtr_[ib];
+
+    const std::size_t nnzb = rowPtr_[Nb_];
+    colInd_.assign(nnzb, 0);
+    val_.assign(nnzb * B * B, 0.0);
+
+    // Second pass: sum duplicates straight into their destination block
+    std::vector<std::size_t> cursor(rowPtr_.begin(), rowPtr_.end() - 1);
+
+    forEachBlock([&](std::size_t ib, std::size_t jb, std::size_t ks0, std::size_t ks1,
+                     std::size_t kb0, std::size_t kb1) {
+        double* dst;
+        if (ib == jb) {
+            dst = &diag_[ib * B * B];
+        } else {
+            const std::size_t pos = cursor[ib]++;
+            colInd_[pos] = jb;
+            dst = &val_[pos * B * B];
+        }
+
+        for (std::size_t k = ks0; k < ks1; ++k)
+            dst[(entries_[k].i % B) * B + entries_[k].j % B] += entries_[k].v;
+        for (std::size_t k = kb0; k < kb1; ++k)
+            for (std::size_t q = 0; q < B * B; ++q)
+                dst[q] += blockEntries_[k].v[q];
+    });
+
+    diagInv_.assign(Nb_ * B * B, 0.0);
+    diagInvertible_ = true;
+    for (std::size_t ib = 0; ib < Nb_ && diagInvertible_; ++ib)
+        diagInvertible_ = invertBlock<B>(&diag_[ib * B * B], &diagInv_[ib * B * B]);
+    if (!diagInvertible_) {
+        diagInv_.clear();
+        diagInv_.shrink_to_fit();
+    }
+
+    finalized_ = true;
+
+    entries_.clear();
+    entries_.shrink_to_fit();
+    blockEntries_.clear();
+    blockEntries_.shrink_to_fit();
+}
+
+template <std::size_t B>
+VectorDouble SparseSquareMatrixBSRDouble<B>::operator*(const VectorDouble& x) const
+{
+    if (!finalized_)
+        throw std::runtime_error("Error: SparseSquareMatrixBSRDouble not finalized()");
+    if (x.size() != Nb_ * B)
+        throw std::runtime_error("Error: Dimension mismatch in block sparse A*x");
+
+    VectorDouble y(Nb_ * B);
+    const double* xp = x.data();
+    double* yp = y.data();
+
+    parallelFor(Nb_, kRowGrain, [&](std::size_t ib0, std::size_t ib1) {
+        for (std::size_t ib = ib0; ib < ib1; ++ib) {
+            double sum[B] = {};
+
+            blockMultAdd<B>(&diag_[ib * B * B], xp + ib * B, sum);
+
+            for (std::size_t p = rowPtr_[ib]; p < rowPtr_[ib + 1]; ++p)
+                blockMultAdd<B>(&val_[p * B * B], xp + colInd_[p] * B, sum);
+
+            for (std::size_t r = 0; r < B; ++r)
+                yp[ib * B + r] = sum[r];
+        }
+    });
+
+    return y;
+}
+
+template <std::size_t B>
+VectorDouble SparseSquareMatrixBSRDouble<B>::applyBlockJacobi(const VectorDouble& r) const
+{
+    if (!finalized_)
+        throw std::runtime_error("Error: SparseSquareMatrixBSRDouble not finalized()");
+    if (r.size() != Nb_ * B)
+        throw std::runtime_error("Error: Dimension mismatch in block Jacobi");
+    if (!diagInvertible_)
+        throw std::runtime_error("Error: Singular diagonal block in block Jacobi");
+
+    VectorDouble z(Nb_ * B);
+    const double* rp = r.data();
+    double* zp = z.data();
+
+    parallelFor(Nb_, kRowGrain, [&](std::size_t ib0, std::size_t ib1) {
+        for (std::size_t ib = ib0; ib < ib1; ++ib) {
+            double out[B] = {};
+            blockMultAdd<B>(&diagInv_[ib * B * B], rp + ib * B, out);
+            for (std::size_t q = 0; q < B; ++q)
+                zp[ib * B + q] = out[q];
+        }
+    });
+
+    return z;
+}
+
+template class SparseSquareMatrixBSRDouble<2>;
+template class SparseSquareMatrixBSRDouble<3>;
+template class SparseSquareMatrixBSRDouble<4>;
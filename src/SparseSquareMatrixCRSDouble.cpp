@@ -1,5 +1,9 @@
 #include "SparseSquareMatrixCRSDouble.hpp"
+#include "SimdDispatch.hpp"
+#include "ComputePool.hpp"
+#include "NumaMemory.hpp"
 #include <algorithm>
+#include <atomic>
 #include <stdexcept>
 #include <cmath>
 
@@ -7,6 +11,63 @@ SparseSquareMatrixCRSDouble::SparseSquareMatrixCRSDouble(std::size_t N)
     : N_(N), finalized_(false), diag_(N)
 {}
 
+SparseSquareMatrixCRSDouble
+SparseSquareMatrixCRSDouble::fromDense(const DenseSquareMatrixDouble& A, double dropTol)
+{
+    const std::size_t N = A.size();
+    SparseSquareMatrixCRSDouble S(N);
+
+    // rows are already in column order, so CRS is built directly in two
+    // passes instead of through the triplet sort. The arrays are allocated
+    // untouched and first written by the row-owning threads.
+    S.rowPtr_.resize(N + 1);
+    S.rowPtr_[0] = 0;
+    parallelFor(N, kRowGrain, [&](std::size_t i0, std::size_t i1) {
+        for (std::size_t i = i0; i < i1; ++i) {
+            S.diag_[i] = A(i, i);
+            std::size_t cnt = 0;
+            for (std::size_t j = 0; j < N; ++j)
+                if (j != i && std::abs(A(i, j)) > dropTol)
+                    ++cnt;
+            S.rowPtr_[i + 1] = cnt;
+        }
+    });
+    for (std::size_t i = 0; i < N; ++i)
+        S.rowPtr_[i + 1] += S.rowPtr_[i];
+
+    S.colInd_.resize(S.rowPtr_[N]);
+    S.val_.resize(S.rowPtr_[N]);
+    parallelFor(N, kRowGrain, [&](std::size_t i0, std::size_t i1) {
+        for (std::size_t i = i0; i < i1; ++i) {
+            std::size_t pos = S.rowPtr_[i];
+            for (std::size_t j = 0; j < N; ++j) {
+                if (j != i && std::abs(A(i, j)) > dropTol) {
+                    S.colInd_[pos] = j;
+                    S.val_[pos] = A(i, j);
+                    ++pos;
+                }
+            }
+        }
+    });
+
+    S.finalized_ = true;
+    return S;
+}
+
+DenseSquareMatrixDouble SparseSquareMatrixCRSDouble::toDense() const
+{
+    if (!finalized_)
+        throw std::runtime_error("Error: SparseSquareMatrixCRSDouble not finalized()");
+
+    DenseSquareMatrixDouble A(N_);
+    for (std::size_t i = 0; i < N_; ++i) {
+        A(i, i) = diag_[i];
+        for (std::size_t p = rowPtr_[i]; p < rowPtr_[i + 1]; ++p)
+            A(i, colInd_[p]) = val_[p];
+    }
+    return A;
+}
+
 std::size_t SparseSquareMatrixCRSDouble::size() const noexcept { return N_; }
 std::size_t SparseSquareMatrixCRSDouble::nnz()  const noexcept { return val_.size(); }
 
@@ -29,7 +90,6 @@ void SparseSquareMatrixCRSDouble::finalize()
     for (std::size_t i = 0; i < N_; ++i) {
         diag_[i] = 0.0;
     }
-    rowPtr_.assign(N_ + 1, 0);
     colInd_.clear();
     val_.clear();
 
@@ -42,13 +102,20 @@ void SparseSquareMatrixCRSDouble::finalize()
                   return a.j < b.j;
               });
 
-    // First pass: count unique OFF-diagonal entries per row,
+    // First pass: count unique OFF-diagonal entries per row, and remember
+    // where each row starts in the sorted triplets
+    std::vector<std::size_t> rowCount(N_ + 1, 0);
+    std::vector<std::size_t> rowEntry(N_ + 1, entries_.size());
     std::size_t k = 0;
+    std::size_t nextRow = 0;
     while (k < entries_.size()) {
         std::size_t i = entries_[k].i;
         std::size_t j = entries_[k].j;
         double sum = entries_[k].v;
 
+        while (nextRow <= i)
+            rowEntry[nextRow++] = k;
+
         std::size_t k2 = k + 1;
         while (k2 < entries_.size() && entries_[k2].i == i && entries_[k2].j == j) {
             sum += entries_[k2].v;
@@ -58,7 +125,7 @@ void SparseSquareMatrixCRSDouble::finalize()
         if (i == j) {
             diag_[i] += sum;
         } else {
-            rowPtr_[i + 1] += 1; // one unique off-diag entry in row i
+            rowCount[i + 1] += 1; // one unique off-diag entry in row i
         }
 
         k = k2;
@@ -66,35 +133,43 @@ void SparseSquareMatrixCRSDouble::finalize()
 
     // Prefix sum to build rowPtr
     for (std::size_t i = 0; i < N_; ++i)
-        rowPtr_[i + 1] += rowPtr_[i];
+        rowCount[i + 1] += rowCount[i];
 
-    const std::size_t nnz_off = rowPtr_[N_];
-    colInd_.assign(nnz_off, 0);
-    val_.assign(nnz_off, 0.0);
+    // Second pass: fill rowPtr/colInd/val for OFF-diagonal, row-parallel.
+    // The arrays are allocated untouched, so each row's pages are first
+    // written by the thread that owns the row in SpMV.
+    const std::size_t nnz_off = rowCount[N_];
+    rowPtr_.resize(N_ + 1);
+    colInd_.resize(nnz_off);
+    val_.resize(nnz_off);
+    rowPtr_[0] = 0;
 
-    // Second pass: fill colInd/val for OFF-diagonal
-    std::vector<std::size_t> cursor = rowPtr_;
+    parallelFor(N_, kRowGrain, [&](std::size_t i0, std::size_t i1) {
+        for (std::size_t i = i0; i < i1; ++i) {
+            rowPtr_[i + 1] = rowCount[i + 1];
 
-    k = 0;
-    while (k < entries_.size()) {
-        std::size_t i = entries_[k].i;
-        std::size_t j = entries_[k].j;
-        double sum = entries_[k].v;
+            std::size_t pos = rowCount[i];
+            std::size_t kk = rowEntry[i];
+            while (kk < rowEntry[i + 1]) {
+                const std::size_t j = entries_[kk].j;
+                double sum = entries_[kk].v;
 
-        std::size_t k2 = k + 1;
-        while (k2 < entries_.size() && entries_[k2].i == i && entries_[k2].j == j) {
-            sum += entries_[k2].v;
-            ++k2;
-        }
+                std::size_t k2 = kk + 1;
+                while (k2 < rowEntry[i + 1] && entries_[k2].j == j) {
+                    sum += entries_[k2].v;
+                    ++k2;
+                }
 
-        if (i != j) {
-            std::size_t pos = cursor[i]++;
-            colInd_[pos] = j;
-            val_[pos] = sum;
-        }
+                if (i != j) {
+                    colInd_[pos] = j;
+                    val_[pos] = sum;
+                    ++pos;
+                }
 
-        k = k2;
-    }
+                kk = k2;
+            }
+        }
+    });
 
     finalized_ = true;
 
@@ -103,24 +178,108 @@ void SparseSquareMatrixCRSDouble::finalize()
 }
 
 VectorDouble SparseSquareMatrixCRSDouble::operator*(const VectorDouble& x) const
+{
+    VectorDouble y(N_);
+    multiply(x, y);
+    return y;
+}
+
+void SparseSquareMatrixCRSDouble::multiply(const VectorDouble& x, VectorDouble& y) const
 {
     if (!finalized_)
         throw std::runtime_error("Error: SparseSquareMatrixCRSDouble not finalized()");
-    if (x.size() != N_)
+    if (x.size() != N_ || y.size() != N_)
         throw std::runtime_error("Error: Dimension mismatch in sparse A*x");
 
-    VectorDouble y(N_);
+    const SimdKernels& k = simdKernels();
+    parallelFor(N_, kRowGrain, [&](std::size_t i0, std::size_t i1) {
+        k.spmvCRS(i0, i1, diag_.data(), rowPtr_.data(), colInd_.data(),
+                  val_.data(), x.data(), y.data());
+    });
+}
 
-    for (std::size_t i = 0; i < N_; ++i) {
-        double sum = diag_[i] * x[i];
+bool SparseSquareMatrixCRSDouble::isSymmetric(double absTol, double relTol) const
+{
+    if (!finalized_)
+        throw std::runtime_error("Error: SparseSquareMatrixCRSDouble not finalized()");
 
-        for (std::size_t p = rowPtr_[i]; p < rowPtr_[i + 1]; ++p) {
-            const std::size_t j = colInd_[p];
-            sum += val_[p] * x[j];
-        }
+    auto mismatch = [&](double a, double b) {
+        const double tol = std::max(absTol, relTol * std::max(std::abs(a), std::abs(b)));
+        return std::abs(a - b) > tol;
+    };
 
-        y[i] = sum;
+    // Transposed pattern: column c lists the positions p of entries (r, c)
+    // in row order. Built in one streaming pass, O(nnz + N).
+    const std::size_t nnzOff = colInd_.size();
+    std::vector<std::size_t> colPtr(N_ + 1, 0), tRow(nnzOff), tPos(nnzOff);
+    for (std::size_t p = 0; p < nnzOff; ++p)
+        ++colPtr[colInd_[p] + 1];
+    for (std::size_t c = 0; c < N_; ++c)
+        colPtr[c + 1] += colPtr[c];
+    {
+        std::vector<std::size_t> fill(colPtr.begin(), colPtr.end() - 1);
+        for (std::size_t i = 0; i < N_; ++i)
+            for (std::size_t p = rowPtr_[i]; p < rowPtr_[i + 1]; ++p) {
+                const std::size_t q = fill[colInd_[p]]++;
+                tRow[q] = i;
+                tPos[q] = p;
+            }
     }
 
-    return y;
+    // Row i of A against column i of A, both sorted, merged row-parallel:
+    // an entry present on one side only is compared with zero
+    std::atomic<bool> symmetric(true);
+
+    parallelFor(N_, 256, [&](std::size_t i0, std::size_t i1) {
+        for (std::size_t i = i0; i < i1; ++i) {
+            if (!symmetric.load(std::memory_order_relaxed))
+                return;
+
+            std::size_t p = rowPtr_[i], q = colPtr[i];
+            const std::size_t pEnd = rowPtr_[i + 1], qEnd = colPtr[i + 1];
+            while (p < pEnd || q < qEnd) {
+                double a = 0.0, b = 0.0;
+                if (q == qEnd || (p < pEnd && colInd_[p] < tRow[q])) {
+                    a = val_[p++];
+                } else if (p == pEnd || tRow[q] < colInd_[p]) {
+                    b = val_[tPos[q++]];
+                } else {
+                    a = val_[p++];
+                    b = val_[tPos[q++]];
+                }
+                if (mismatch(a, b)) {
+                    symmetric.store(false, std::memory_order_relaxed);
+                    return;
+                }
+            }
+        }
+    });
+
+    return symmetric.load();
+}
+
+bool SparseSquareMatrixCRSDouble::isDiagonallyDominant(double relTol) const
+{
+    if (!finalized_)
+        throw std::runtime_error("Error: SparseSquareMatrixCRSDouble not finalized()");
+
+    std::atomic<bool> dominant(true);
+
+    parallelFor(N_, 256, [&](std::size_t i0, std::size_t i1) {
+        for (std::size_t i = i0; i < i1; ++i) {
+            if (!dominant.load(std::memory_order_relaxed))
+                return;
+
+            double off_sum = 0.0;
+            for (std::size_t p = rowPtr_[i]; p < rowPtr_[i + 1]; ++p)
+                off_sum += std::abs(val_[p]);
+
+            if (std::abs(diag_[i]) < (1.0 - relTol) * off_sum) {
+                dominant.store(false, std::memory_order_relaxed);
+                return;
+            }
+        }
+    });
+
+    return dominant.load();
 }
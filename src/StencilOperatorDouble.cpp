@@ -0,0 +1,211 @@
+#include "StencilOperatorDouble.hpp"
+#include "ComputePool.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// rows of the three planes a slab touches should fit in L2 together
+constexpr std::size_t kSlabBytes = 256 * 1024;
+
+// out[i] += wm * row[i-1] + w0 * row[i] + wp * row[i+1], ends dropped
+inline void rowTriad(double* out, const double* row,
+                     double wm, double w0, double wp, std::size_t nx)
+{
+    if (nx == 1) {
+        out[0] += w0 * row[0];
+        return;
+    }
+    out[0] += w0 * row[0] + wp * row[1];
+    for (std::size_t i = 1; i + 1 < nx; ++i)
+        out[i] += wm * row[i - 1] + w0 * row[i] + wp * row[i + 1];
+    out[nx - 1] += wm * row[nx - 2] + w0 * row[nx - 1];
+}
+
+// same with per-point weights
+inline void rowTriadVar(double* out, const double* row,
+                        const double* wm, const double* w0, const double* wp, std::size_t nx)
+{
+    if (nx == 1) {
+        out[0] += w0[0] * row[0];
+        return;
+    }
+    out[0] += w0[0] * row[0] + wp[0] * row[1];
+    for (std::size_t i = 1; i + 1 < nx; ++i)
+        out[i] += wm[i] * row[i - 1] + w0[i] * row[i] + wp[i] * row[i + 1];
+    out[nx - 1] += wm[nx - 1] * row[nx - 2] + w0[nx - 1] * row[nx - 1];
+}
+
+inline void rowAxpy(double* out, const double* row, double w, std::size_t nx)
+{
+    for (std::size_t i = 0; i < nx; ++i)
+        out[i] += w * row[i];
+}
+
+inline void rowAxpyVar(double* out, const double* row, const double* w, std::size_t nx)
+{
+    for (std::size_t i = 0; i < nx; ++i)
+        out[i] += w[i] * row[i];
+}
+
+// Calls rowFn(y, z) for every grid row. Slabs of y-rows are swept through
+// all z (2.5D blocking); slabs, and z ranges when slabs are too few to keep
+// every thread busy, are spread over the ComputePool.
+template <class RowFn>
+void sweepRows(std::size_t nx, std::size_t ny, std::size_t nz, RowFn rowFn)
+{
+    if (nx == 0 || ny == 0 || nz == 0)
+        return;
+
+    const std::size_t rowsPerSlab = std::max<std::size_t>(1, kSlabBytes / (3 * nx * sizeof(double)));
+    const std::size_t slabs = (ny + rowsPerSlab - 1) / rowsPerSlab;
+    const std::size_t threads = ComputePool::instance().numThreads();
+    const std::size_t zParts = std::max<std::size_t>(1, std::min(nz, (threads + slabs - 1) / slabs));
+
+    parallelFor(slabs * zParts, 1, [&](std::size_t u0, std::size_t u1) {
+        for (std::size_t u = u0; u < u1; ++u) {
+            const std::size_t slab = u / zParts;
+            const std::size_t part = u % zParts;
+            const std::size_t y0 = slab * rowsPerSlab;
+            const std::size_t y1 = std::min(ny, y0 + rowsPerSlab);
+            const std::size_t z0 = ComputePool::chunkBegin(nz, zParts, part);
+            const std::size_t z1 = ComputePool::chunkBegin(nz, zParts, part + 1);
+
+            for (std::size_t z = z0; z < z1; ++z)
+                for (std::size_t y = y0; y < y1; ++y)
+                    rowFn(y, z);
+        }
+    });
+}
+
+template <std::size_t K>
+void checkVariable(const std::array<std::vector<double>, K>& c, std::size_t n)
+{
+    for (const std::vector<double>& v : c)
+        if (v.size() != n)
+            throw std::runtime_error("Error: Stencil coefficient field size mismatch");
+}
+
+void checkApply(const VectorDouble& x, const VectorDouble& y, std::size_t n)
+{
+    if (x.size() != n || y.size() != n)
+        throw std::runtime_error("Error: Dimension mismatch in stencil apply");
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// 7-point / 5-point
+// ---------------------------------------------------------------------------
+
+StencilOperator7Double::StencilOperator7Double(std::size_t nx, std::size_t ny, std::size_t nz,
+                                               const Coefficients& c)
+    : nx_(nx), ny_(ny), nz_(nz), variable_(false), c_(c)
+{}
+
+StencilOperator7Double::StencilOperator7Double(std::size_t nx, std::size_t ny, std::size_t nz,
+                                               std::array<std::vector<double>, 7>&& c)
+    : nx_(nx), ny_(ny), nz_(nz), variable_(true), c_(), cv_(std::move(c))
+{
+    checkVariable(cv_, nx_ * ny_ * nz_);
+}
+
+StencilOperator7Double StencilOperator7Double::laplacian(std::size_t nx, std::size_t ny,
+                                                         std::size_t nz, double h)
+{
+    const double dim = static_cast<double>((nx > 1) + (ny > 1) + (nz > 1));
+    const double s = 1.0 / (h * h);
+    return StencilOperator7Double(nx, ny, nz, {2.0 * dim * s, -s, -s, -s, -s, -s, -s});
+}
+
+std::size_t StencilOperator7Double::size() const noexcept
+{
+    return nx_ * ny_ * nz_;
+}
+
+void StencilOperator7Double::apply(const VectorDouble& x, VectorDouble& y) const
+{
+    checkApply(x, y, size());
+
+    const std::size_t nx = nx_, ny = ny_, nz = nz_;
+    const std::size_t plane = nx * ny;
+    const double* xp = x.data();
+    double* yp = y.data();
+
+    sweepRows(nx, ny, nz, [&](std::size_t j, std::size_t k) {
+        const std::size_t row = k * plane + j * nx;
+        double* out = yp + row;
+        std::fill(out, out + nx, 0.0);
+
+        if (!variable_) {
+            rowTriad(out, xp + row, c_[1], c_[0], c_[2], nx);
+            if (j > 0)      rowAxpy(out, xp + row - nx, c_[3], nx);
+            if (j + 1 < ny) rowAxpy(out, xp + row + nx, c_[4], nx);
+            if (k > 0)      rowAxpy(out, xp + row - plane, c_[5], nx);
+            if (k + 1 < nz) rowAxpy(out, xp + row + plane, c_[6], nx);
+        } else {
+            rowTriadVar(out, xp + row, &cv_[1][row], &cv_[0][row], &cv_[2][row], nx);
+            if (j > 0)      rowAxpyVar(out, xp + row - nx, &cv_[3][row], nx);
+            if (j + 1 < ny) rowAxpyVar(out, xp + row + nx, &cv_[4][row], nx);
+            if (k > 0)      rowAxpyVar(out, xp + row - plane, &cv_[5][row], nx);
+            if (k + 1 < nz) rowAxpyVar(out, xp + row + plane, &cv_[6][row], nx);
+        }
+    });
+}
+
+// ---------------------------------------------------------------------------
+// 27-point / 9-point
+// ---------------------------------------------------------------------------
+
+StencilOperator27Double::StencilOperator27Double(std::size_t nx, std::size_t ny, std::size_t nz,
+                                                 const Coefficients& w)
+    : nx_(nx), ny_(ny), nz_(nz), variable_(false), w_(w)
+{}
+
+StencilOperator27Double::StencilOperator27Double(std::size_t nx, std::size_t ny, std::size_t nz,
+                                                 std::array<std::vector<double>, 27>&& w)
+    : nx_(nx), ny_(ny), nz_(nz), variable_(true), w_(), wv_(std::move(w))
+{
+    checkVariable(wv_, nx_ * ny_ * nz_);
+}
+
+std::size_t StencilOperator27Double::size() const noexcept
+{
+    return nx_ * ny_ * nz_;
+}
+
+void StencilOperator27Double::apply(const VectorDouble& x, VectorDouble& y) const
+{
+    checkApply(x, y, size());
+
+    const std::size_t nx = nx_, ny = ny_, nz = nz_;
+    const std::size_t plane = nx * ny;
+    const double* xp = x.data();
+    double* yp = y.data();
+
+    sweepRows(nx, ny, nz, [&](std::size_t j, std::size_t k) {
+        const std::size_t row = k * plane + j * nx;
+        double* out = yp + row;
+        std::fill(out, out + nx, 0.0);
+
+        for (int dz = -1; dz <= 1; ++dz) {
+            if ((dz < 0 && k == 0) || (dz > 0 && k + 1 == nz))
+                continue;
+            for (int dy = -1; dy <= 1; ++dy) {
+                if ((dy < 0 && j == 0) || (dy > 0 && j + 1 == ny))
+                    continue;
+
+                const double* src = xp + row
+                                  + static_cast<std::ptrdiff_t>(dz) * static_cast<std::ptrdiff_t>(plane)
+                                  + static_cast<std::ptrdiff_t>(dy) * static_cast<std::ptrdiff_t>(nx);
+                const std::size_t w0 = static_cast<std::size_t>((dz + 1) * 9 + (dy + 1) * 3);
+
+                if (!variable_)
+                    rowTriad(out, src, w_[w0], w_[w0 + 1], w_[w0 + 2], nx);
+                else
+                    rowTriadVar(out, src, &wv_[w0][row], &wv_[w0 + 1][row], &wv_[w0 + 2][row], nx);
+            }
+        }
+    });
+}
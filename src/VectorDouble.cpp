@@ -1,21 +1,22 @@
 #include "VectorDouble.hpp"
+#include "SimdDispatch.hpp"
+#include "NumaMemory.hpp"
 #include <algorithm>
 #include <cmath>
 #include <stdexcept>
 #include <utility>
 
+// storage is allocated untouched and first-touched in parallel, see NumaMemory.hpp
 VectorDouble::VectorDouble(std::size_t vol)
-    : vol_(vol), data_(std::make_unique<double[]>(vol))
+    : vol_(vol), data_(new double[vol])
 {
-    for (std::size_t i = 0; i < vol_; ++i)
-        data_[i] = 0.0;
+    firstTouchFill(data_.get(), vol_, 0.0);
 }
 
 VectorDouble::VectorDouble(const VectorDouble& other)
-    : vol_(other.vol_), data_(std::make_unique<double[]>(other.vol_))
+    : vol_(other.vol_), data_(new double[other.vol_])
 {
-    for (std::size_t i = 0; i < vol_; ++i)
-        data_[i] = other.data_[i];
+    firstTouchCopy(data_.get(), other.data_.get(), vol_);
 }
 
 VectorDouble& VectorDouble::operator=(const VectorDouble& other)
@@ -25,11 +26,10 @@ VectorDouble& VectorDouble::operator=(const VectorDouble& other)
 
     if (vol_ != other.vol_) {
         vol_ = other.vol_;
-        data_ = std::make_unique<double[]>(vol_);
+        data_.reset(new double[vol_]);
     }
 
-    for (std::size_t i = 0; i < vol_; ++i)
-        data_[i] = other.data_[i];
+    firstTouchCopy(data_.get(), other.data_.get(), vol_);
 
     return *this;
 }
@@ -67,14 +67,23 @@ const double& VectorDouble::operator[](std::size_t i) const
     return data_[i];
 }
 
+double* VectorDouble::data() noexcept
+{
+    return data_.get();
+}
+
+const double* VectorDouble::data() const noexcept
+{
+    return data_.get();
+}
+
 VectorDouble VectorDouble::operator+(const VectorDouble& other) const
 {
     if (vol_ != other.vol_)
         throw std::runtime_error("Error: Vector size mismatch (+)");
 
     VectorDouble result(vol_);
-    for (std::size_t i = 0; i < vol_; ++i)
-        result[i] = data_[i] + other.data_[i];
+    simdKernels().add(data_.get(), other.data_.get(), result.data_.get(), vol_);
 
     return result;
 }
@@ -85,8 +94,7 @@ VectorDouble VectorDouble::operator-(const VectorDouble& other) const
         throw std::runtime_error("Error: Vector size mismatch (-)");
 
     VectorDouble result(vol_);
-    for (std::size_t i = 0; i < vol_; ++i)
-        result[i] = data_[i] - other.data_[i];
+    simdKernels().sub(data_.get(), other.data_.get(), result.data_.get(), vol_);
 
     return result;
 }
@@ -94,17 +102,37 @@ VectorDouble VectorDouble::operator-(const VectorDouble& other) const
 VectorDouble VectorDouble::operator*(double scalar) const
 {
     VectorDouble result(vol_);
-    for (std::size_t i = 0; i < vol_; ++i)
-        result[i] = data_[i] * scalar;
+    simdKernels().scale(data_.get(), scalar, result.data_.get(), vol_);
 
     return result;
 }
 
+double VectorDouble::dot(const VectorDouble& other) const
+{
+    if (vol_ != other.vol_)
+        throw std::runtime_error("Error: Vector size mismatch (dot)");
+
+    return simdKernels().dot(data_.get(), other.data_.get(), vol_);
+}
+
+void VectorDouble::axpy(double alpha, const VectorDouble& x)
+{
+    if (vol_ != x.vol_)
+        throw std::runtime_error("Error: Vector size mismatch (axpy)");
+
+    simdKernels().axpy(alpha, x.data_.get(), data_.get(), vol_);
+}
+
 double VectorDouble::norm_n(int n) const
 {
     if (n <= 0)
         throw std::runtime_error("Error: Invalid norm parameter");
 
+    if (n == 2)
+        return std::sqrt(simdKernels().dot(data_.get(), data_.get(), vol_));
+
+    // other n stay scalar, outside the SIMD dispatch: the cost is the
+    // per-element std::pow, which none of the kernel levels vectorise
     double sum = 0.0;
 
     for (std::size_t i = 0; i < vol_; ++i)
@@ -115,10 +143,5 @@ double VectorDouble::norm_n(int n) const
 
 double VectorDouble::normInf() const
 {
-    double maxVal = 0.0;
-
-    for (std::size_t i = 0; i < vol_; ++i)
-        maxVal = std::max(maxVal, std::abs(data_[i]));
-
-    return maxVal;
+    return simdKernels().maxAbs(data_.get(), vol_);
 }
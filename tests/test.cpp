@@ -1,10 +1,37 @@
 #include <iostream>
 #include <cmath>
 #include <stdexcept>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <string>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
 
 #include "VectorDouble.hpp"
 #include "DenseSquareMatrixDouble.hpp"
 #include "LinearSystemDense.hpp"
+#include "SparseSquareMatrixCRSDouble.hpp"
+#include "SparseSquareMatrixBSRDouble.hpp"
+#include "SimdDispatch.hpp"
+#include "ComputePool.hpp"
+#include "LinearSystemDenseBatched.hpp"
+#include "LinearSystemSparse.hpp"
+#include "LinearSystemOperator.hpp"
+#include "StencilOperatorDouble.hpp"
+#include "LinearSystemAuto.hpp"
+#include "OutOfCoreSparseMatrixCRSDouble.hpp"
+#include "KrylovSolvers.hpp"
+#include "NumaMemory.hpp"
+#include "SolveService.hpp"
+#include "FixedSquareMatrixDouble.hpp"
 
 static void expect_near(double a, double b, double tol, const char* msg)
 {
@@ -217,6 +244,1173 @@ static void test_symmetry_and_diag_dominance()
     std::cout << "  OK\n";
 }
 
+static void test_bsr_mv_and_block_jacobi()
+{
+    std::cout << "Running test_bsr_mv_and_block_jacobi...\n";
+
+    // 2 block rows of 3x3 blocks, checked against the scalar CRS matrix
+    SparseSquareMatrixBSRDouble<3> A(2);
+    SparseSquareMatrixCRSDouble S(6);
+
+    SparseSquareMatrixBSRDouble<3>::Block D0 = {4, 1, 0,
+                                                1, 5, 1,
+                                                0, 1, 6};
+    A.addBlock(0, 0, D0);
+    A.addBlock(1, 1, D0);
+    for (std::size_t r = 0; r < 3; ++r)
+        for (std::size_t c = 0; c < 3; ++c) {
+            S.addEntry(r, c, D0[r * 3 + c]);
+            S.addEntry(3 + r, 3 + c, D0[r * 3 + c]);
+        }
+
+    // scalar entries land in the (0,1) block, duplicates are summed
+    A.addEntry(0, 4, 1.5);
+    A.addEntry(0, 4, 0.5);
+    A.addEntry(2, 3, -1.0);
+    A.addEntry(5, 1, 3.0);
+    S.addEntry(0, 4, 2.0);
+    S.addEntry(2, 3, -1.0);
+    S.addEntry(5, 1, 3.0);
+
+    A.finalize();
+    S.finalize();
+
+    expect_true(A.size() == 6, "BSR scalar size");
+    expect_true(A.nnzBlocks() == 2, "BSR should store two off-diagonal blocks");
+
+    VectorDouble x(6);
+    for (std::size_t i = 0; i < 6; ++i)
+        x[i] = static_cast<double>(i + 1);
+
+    VectorDouble y = A * x;
+    VectorDouble yRef = S * x;
+    expect_near((y - yRef).normInf(), 0.0, 1e-12, "BSR A*x should match CRS A*x");
+
+    // block Jacobi on a block-diagonal-only matrix is an exact solve
+    SparseSquareMatrixBSRDouble<3> Dm(2);
+    Dm.addBlock(0, 0, D0);
+    Dm.addBlock(1, 1, D0);
+    Dm.finalize();
+    expect_true(Dm.blockDiagonalInvertible(), "Diagonal blocks should be invertible");
+
+    VectorDouble z = Dm.applyBlockJacobi(Dm * x);
+    expect_near((z - x).normInf(), 0.0, 1e-12, "Block Jacobi should invert block diagonal");
+
+    // enough block rows for several pool chunks; scalar and block entries
+    // land in the same blocks
+    const std::size_t nb = 300;
+    SparseSquareMatrixBSRDouble<4> L(nb);
+    SparseSquareMatrixCRSDouble Ls(4 * nb);
+    SparseSquareMatrixBSRDouble<4>::Block blk;
+    for (std::size_t q = 0; q < 16; ++q)
+        blk[q] = 0.1 * static_cast<double>(q + 1);
+    for (std::size_t ib = 0; ib < nb; ++ib) {
+        const std::size_t jb = (ib * 7 + 3) % nb;
+        L.addBlock(ib, jb, blk);
+        for (std::size_t q = 0; q < 16; ++q)
+            Ls.addEntry(ib * 4 + q / 4, jb * 4 + q % 4, blk[q]);
+        for (std::size_t r = 0; r < 4; ++r) {
+            const std::size_t i = ib * 4 + r;
+            const std::size_t j = (i * 5 + 1) % (4 * nb);
+            L.addEntry(i, i, 3.0);
+            L.addEntry(i, j, -0.5);
+            Ls.addEntry(i, i, 3.0);
+            Ls.addEntry(i, j, -0.5);
+        }
+    }
+    L.finalize();
+    Ls.finalize();
+    VectorDouble xl(4 * nb);
+    for (std::size_t i = 0; i < xl.size(); ++i)
+        xl[i] = std::sin(0.01 * static_cast<double>(i));
+    expect_near((L * xl - Ls * xl).normInf(), 0.0, 1e-12, "Row-parallel BSR A*x matches CRS");
+
+    SparseSquareMatrixBSRDouble<2> E(0);
+    E.finalize();
+    expect_true((E * VectorDouble(0)).size() == 0, "Empty BSR A*x");
+
+    std::cout << "  OK\n";
+}
+
+static void test_simd_dispatch_levels()
+{
+    std::cout << "Running test_simd_dispatch_levels (selected: "
+              << simdLevelName(simdLevel()) << ")...\n";
+
+    // odd length so every level exercises its remainder path
+    const std::size_t n = 19;
+    double a[n], b[n];
+    for (std::size_t i = 0; i < n; ++i) {
+        a[i] = 0.5 * static_cast<double>(i) - 3.0;
+        b[i] = 1.0 / static_cast<double>(i + 1);
+    }
+
+    // 4x4 CRS: off-diagonals (0,1..3), (2,0), (3,2)
+    const std::size_t rowPtr[5] = {0, 3, 3, 4, 5};
+    const std::size_t colInd[5] = {1, 2, 3, 0, 2};
+    const double val[5] = {1.0, -2.0, 0.5, 3.0, -1.0};
+    const double diag[4] = {4.0, 4.0, 4.0, 4.0};
+    const double xs[4] = {1.0, 2.0, 3.0, 4.0};
+
+    const SimdKernels& ref = simdKernels(SimdLevel::Scalar);
+    double yRef[4];
+    ref.spmvCRS(0, 4, diag, rowPtr, colInd, val, xs, yRef);
+
+    // rows of 17, 13, 9, 8, 4, 3, 1 and 0 off-diagonals over 20 columns
+    const std::size_t rowLen[] = {17, 13, 9, 8, 4, 3, 1, 0, 16, 5};
+    const std::size_t nLong = sizeof(rowLen) / sizeof(rowLen[0]);
+    const std::size_t nCols = 20;
+    std::vector<std::size_t> rowPtrLong(nLong + 1, 0), colIndLong;
+    std::vector<double> valLong, diagLong(nCols, 2.0), xLong(nCols), yLong(nLong), yLongRef(nLong);
+    for (std::size_t r = 0; r < nLong; ++r) {
+        for (std::size_t q = 0; q < rowLen[r]; ++q) {
+            colIndLong.push_back((r + 3 * q + 1) % nCols);
+            valLong.push_back(0.25 * static_cast<double>(q + 1) - static_cast<double>(r % 3));
+        }
+        rowPtrLong[r + 1] = colIndLong.size();
+    }
+    for (std::size_t i = 0; i < nCols; ++i)
+        xLong[i] = std::cos(static_cast<double>(i));
+    ref.spmvCRS(0, nLong, diagLong.data(), rowPtrLong.data(), colIndLong.data(),
+                valLong.data(), xLong.data(), yLongRef.data());
+
+    const SimdLevel levels[] = {SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512};
+    for (SimdLevel level : levels) {
+        const SimdKernels& k = simdKernels(level);
+
+        expect_near(k.dot(a, b, n), ref.dot(a, b, n), 1e-12, "SIMD dot");
+        expect_near(k.maxAbs(a, n), ref.maxAbs(a, n), 0.0, "SIMD maxAbs");
+
+        double out[n], outRef[n];
+        k.add(a, b, out, n);
+        ref.add(a, b, outRef, n);
+        for (std::size_t i = 0; i < n; ++i)
+            expect_near(out[i], outRef[i], 0.0, "SIMD add");
+
+        for (std::size_t i = 0; i < n; ++i)
+            out[i] = outRef[i] = b[i];
+        k.axpy(2.0, a, out, n);
+        ref.axpy(2.0, a, outRef, n);
+        for (std::size_t i = 0; i < n; ++i)
+            expect_near(out[i], outRef[i], 1e-12, "SIMD axpy");
+
+        double y[4];
+        k.spmvCRS(0, 4, diag, rowPtr, colInd, val, xs, y);
+        for (std::size_t i = 0; i < 4; ++i)
+            expect_near(y[i], yRef[i], 1e-12, "SIMD CRS SpMV");
+
+        // long rows run the 4-wide (AVX2) and 8-wide (AVX-512) gather loops,
+        // odd lengths their tails
+        for (std::size_t r = 0; r < nLong; ++r)
+            yLong[r] = -1.0;
+        k.spmvCRS(0, nLong, diagLong.data(), rowPtrLong.data(), colIndLong.data(),
+                  valLong.data(), xLong.data(), yLong.data());
+        for (std::size_t r = 0; r < nLong; ++r)
+            expect_near(yLong[r], yLongRef[r], 1e-12, "SIMD CRS SpMV long rows");
+
+        // NaN anywhere (vector body or tail) gives NaN at every level
+        for (std::size_t pos : {std::size_t(0), std::size_t(9), n - 1}) {
+            double c[n];
+            for (std::size_t i = 0; i < n; ++i)
+                c[i] = a[i];
+            c[pos] = std::nan("");
+            expect_true(std::isnan(k.maxAbs(c, n)), "SIMD maxAbs propagates NaN");
+            expect_true(std::isnan(ref.maxAbs(c, n)), "Scalar maxAbs propagates NaN");
+        }
+    }
+
+    std::cout << "  OK\n";
+}
+
+static void test_compute_pool_parallel_for()
+{
+    std::cout << "Running test_compute_pool_parallel_for ("
+              << ComputePool::instance().numThreads() << " threads)...\n";
+
+    const std::size_t n = 1000;
+    std::vector<int> hits(n, 0);
+    std::atomic<std::size_t> chunks(0);
+
+    parallelFor(n, 16, [&](std::size_t begin, std::size_t end) {
+        ++chunks;
+        for (std::size_t i = begin; i < end; ++i)
+            hits[i] += 1;
+    });
+
+    for (std::size_t i = 0; i < n; ++i)
+        expect_true(hits[i] == 1, "parallelFor should visit every index once");
+    expect_true(chunks.load() <= ComputePool::instance().numThreads(),
+                "parallelFor should use at most one chunk per thread");
+
+    bool thrown = false;
+    try {
+        parallelFor(n, 1, [](std::size_t begin, std::size_t) {
+            if (begin == 0)
+                throw std::runtime_error("chunk failure");
+        });
+    }
+    catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    expect_true(thrown, "parallelFor should rethrow chunk exceptions");
+
+    std::cout << "  OK\n";
+}
+
+static void test_batched_dense_solve()
+{
+    std::cout << "Running test_batched_dense_solve...\n";
+
+    // 11 systems: one full group of 8 plus a padded tail group
+    const std::size_t N = 5;
+    const std::size_t count = 11;
+    LinearSystemDenseBatched batch(N, count);
+
+    for (std::size_t s = 0; s < count; ++s) {
+        for (std::size_t i = 0; i < N; ++i) {
+            for (std::size_t j = 0; j < N; ++j)
+                batch.A(s, i, j) = 1.0 / static_cast<double>(i + j + s + 1);
+            batch.A(s, i, i) += static_cast<double>(N);
+            batch.x(s, i) = static_cast<double>(i) - static_cast<double>(s % 3);
+        }
+    }
+
+    // cross-check one system against the single-system classes
+    DenseSquareMatrixDouble A3(N);
+    VectorDouble x3(N);
+    for (std::size_t i = 0; i < N; ++i) {
+        x3[i] = batch.x(3, i);
+        for (std::size_t j = 0; j < N; ++j)
+            A3(i, j) = batch.A(3, i, j);
+    }
+
+    batch.multiply(); // b_s = A_s x_s
+    VectorDouble b3 = A3 * x3;
+    for (std::size_t i = 0; i < N; ++i)
+        expect_near(batch.b(3, i), b3[i], 1e-12, "Batched GEMV should match dense A*x");
+
+    std::vector<VectorDouble> exact;
+    for (std::size_t s = 0; s < count; ++s) {
+        exact.push_back(batch.getX(s));
+        for (std::size_t i = 0; i < N; ++i)
+            batch.x(s, i) = 0.0;
+    }
+
+    batch.solveLU();
+    VectorDouble rn = batch.residualNormInf();
+    for (std::size_t s = 0; s < count; ++s) {
+        expect_near(rn[s], 0.0, 1e-12, "Batched LU residual should vanish");
+        expect_near((batch.getX(s) - exact[s]).normInf(), 0.0, 1e-12, "Batched LU solution");
+    }
+
+    // the matrices are symmetric and diagonally dominant, hence SPD
+    for (std::size_t s = 0; s < count; ++s)
+        for (std::size_t i = 0; i < N; ++i)
+            batch.x(s, i) = 0.0;
+
+    batch.solveCholesky();
+    for (std::size_t s = 0; s < count; ++s) {
+        expect_near(batch.residual(s).normInf(), 0.0, 1e-12, "Batched Cholesky residual should vanish");
+        expect_near((batch.getX(s) - exact[s]).normInf(), 0.0, 1e-12, "Batched Cholesky solution");
+    }
+
+    // zero or tiny leading pivots in some lanes only, so the pivot search
+    // swaps rows in those lanes and not in their neighbours
+    LinearSystemDenseBatched piv(N, count);
+    for (std::size_t s = 0; s < count; ++s) {
+        for (std::size_t i = 0; i < N; ++i) {
+            for (std::size_t j = 0; j < N; ++j)
+                piv.A(s, i, j) = static_cast<double>((7 * i + 13 * j + 5 * s) % 11) - 5.0;
+            if (i > 0)
+                piv.A(s, i, i) += 20.0;
+            piv.b(s, i) = static_cast<double>(i + 1) + 0.5 * static_cast<double>(s);
+        }
+        if (s % 3 == 0)
+            piv.A(s, 0, 0) = 0.0;
+        else if (s % 3 == 1)
+            piv.A(s, 0, 0) = 1e-14;
+        else
+            piv.A(s, 0, 0) = 10.0;
+    }
+    piv.solveLU();
+    for (std::size_t s = 0; s < count; ++s) {
+        DenseSquareMatrixDouble As(N);
+        VectorDouble bs(N);
+        for (std::size_t i = 0; i < N; ++i) {
+            bs[i] = piv.b(s, i);
+            for (std::size_t j = 0; j < N; ++j)
+                As(i, j) = piv.A(s, i, j);
+        }
+        const VectorDouble ref = DenseLUDouble(As).solve(bs);
+        expect_near((piv.getX(s) - ref).normInf(), 0.0, 1e-10 * (1.0 + ref.normInf()),
+                    "Batched LU with row swaps should match DenseLUDouble");
+        expect_near(piv.residual(s).normInf(), 0.0, 1e-10, "Batched LU residual with row swaps");
+    }
+
+    // a NaN in one lane shows up in that lane's residual norm only: in
+    // every row through x, or in the first row only through b, where the
+    // finite rows after it must not overwrite it
+    piv.x(9, 2) = std::nan("");
+    piv.b(10, 0) = std::nan("");
+    VectorDouble rnNaN = piv.residualNormInf();
+    for (std::size_t s = 0; s < count; ++s)
+        if (s == 9 || s == 10)
+            expect_true(std::isnan(rnNaN[s]), "NaN lane reports a NaN residual norm");
+        else
+            expect_near(rnNaN[s], 0.0, 1e-10, "Other lanes keep their residual norm");
+
+    // N == 0 is a no-op
+    LinearSystemDenseBatched empty(0, 3);
+    empty.multiply();
+    empty.solveLU();
+    empty.solveCholesky();
+    expect_near(empty.residualNormInf().normInf(), 0.0, 0.0, "Empty batched systems");
+
+    std::cout << "  OK\n";
+}
+
+static void test_structure_checks_tiled_and_sparse()
+{
+    std::cout << "Running test_structure_checks_tiled_and_sparse...\n";
+
+    // 100 spans several 32x32 tiles, including a partial one
+    const std::size_t N = 100;
+    DenseSquareMatrixDouble A(N);
+    for (std::size_t i = 0; i < N; ++i) {
+        A(i, i) = 1.0e6;
+        for (std::size_t j = 0; j < i; ++j) {
+            const double v = 1.0e3 * std::sin(static_cast<double>(i * N + j));
+            A(i, j) = v;
+            A(j, i) = v;
+        }
+    }
+    expect_true(A.isSymmetric(), "Tiled dense symmetry");
+    expect_true(A.isDiagonallyDominant(), "Dense diagonal dominance");
+
+    // perturb one entry in an off-diagonal partial tile
+    A(97, 5) *= 1.0 + 1e-10;
+    expect_false(A.isSymmetric(), "Absolute tolerance should catch 1e-10 relative change");
+    expect_true(A.isSymmetric(0.0, 1e-8), "Relative tolerance should accept 1e-10 relative change");
+
+    A(50, 51) = 2.0e6;
+    expect_false(A.isDiagonallyDominant(), "Row 50 should no longer be dominant");
+
+    // sparse: 1D Laplacian, symmetric and dominant
+    const std::size_t n = 50;
+    SparseSquareMatrixCRSDouble S(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        S.addEntry(i, i, 2.0);
+        if (i > 0)     S.addEntry(i, i - 1, -1.0);
+        if (i + 1 < n) S.addEntry(i, i + 1, -1.0);
+    }
+    S.finalize();
+
+    LinearSystemSparse sys(std::move(S), VectorDouble(n), VectorDouble(n));
+    expect_true(sys.isSymmetric(), "Sparse Laplacian should be symmetric");
+    expect_true(sys.isDiagonallyDominant(), "Sparse Laplacian should be diagonally dominant");
+
+    // an entry whose mirror is missing from the pattern
+    SparseSquareMatrixCRSDouble U(3);
+    U.addEntry(0, 0, 1.0);
+    U.addEntry(2, 0, 0.5);
+    U.finalize();
+    expect_false(U.isSymmetric(), "Missing mirror entry breaks symmetry");
+    expect_false(U.isDiagonallyDominant(), "Zero diagonal in row 2 is not dominant");
+
+    // relative slack on dominance: |a_ii| = 0.99 * off-diagonal sum
+    DenseSquareMatrixDouble D(2);
+    D(0, 0) = 0.99; D(0, 1) = 1.0;
+    D(1, 0) = 1.0;  D(1, 1) = 2.0;
+    SparseSquareMatrixCRSDouble DS = SparseSquareMatrixCRSDouble::fromDense(D);
+    expect_false(D.isDiagonallyDominant(), "0.99 < 1.0 is not dominant");
+    expect_true(D.isDiagonallyDominant(0.02), "2% slack should accept 0.99 vs 1.0");
+    expect_false(D.isDiagonallyDominant(0.005), "0.5% slack should still reject");
+    expect_false(DS.isDiagonallyDominant(), "Sparse: 0.99 < 1.0 is not dominant");
+    expect_true(DS.isDiagonallyDominant(0.02), "Sparse: 2% slack should accept");
+
+    // long banded matrix so the symmetry pass spans several row chunks;
+    // break the mirror in the last chunk only
+    const std::size_t nb = 2000;
+    for (int broken = 0; broken < 2; ++broken) {
+        SparseSquareMatrixCRSDouble B(nb);
+        for (std::size_t i = 0; i < nb; ++i) {
+            B.addEntry(i, i, 10.0);
+            for (std::size_t d : {1u, 7u, 31u})
+                if (i + d < nb) {
+                    const double v = 1.0 / static_cast<double>(i + d);
+                    B.addEntry(i, i + d, v);
+                    B.addEntry(i + d, i, broken && i == nb - 40 && d == 31 ? 0.0 : v);
+                }
+        }
+        B.finalize();
+        expect_true(B.isSymmetric() == (broken == 0), "Banded sparse symmetry across chunks");
+    }
+
+    // irregular patterns against the dense check: symmetric, then with one
+    // mirror dropped above or below the diagonal, then with one value perturbed
+    const std::size_t m = 23;
+    for (int variant = 0; variant < 4; ++variant) {
+        SparseSquareMatrixCRSDouble P(m);
+        for (std::size_t i = 0; i < m; ++i) {
+            P.addEntry(i, i, 4.0);
+            for (std::size_t j = i + 1; j < m; ++j) {
+                if ((i * 7 + j * 3) % 5 != 0)
+                    continue;
+                const double v = 1.0 / static_cast<double>(i + j + 1);
+                if (!(variant == 1 && i == 4))
+                    P.addEntry(i, j, v);
+                if (!(variant == 2 && j == m - 1))
+                    P.addEntry(j, i, variant == 3 && i == 10 ? v + 1e-6 : v);
+            }
+        }
+        P.finalize();
+        expect_true(P.isSymmetric() == P.toDense().isSymmetric(),
+                    "Sparse symmetry check should agree with dense");
+        expect_true(P.isSymmetric() == (variant == 0), "Sparse symmetry variant");
+    }
+
+    std::cout << "  OK\n";
+}
+
+static void test_stencil_operators_matrix_free()
+{
+    std::cout << "Running test_stencil_operators_matrix_free...\n";
+
+    const std::size_t nx = 7, ny = 5, nz = 4;
+    const std::size_t n = nx * ny * nz;
+
+    VectorDouble x(n);
+    for (std::size_t i = 0; i < n; ++i)
+        x[i] = std::cos(0.37 * static_cast<double>(i));
+
+    // variable-coefficient 7-point against the same operator assembled in CRS
+    std::array<std::vector<double>, 7> c;
+    for (std::size_t k = 0; k < 7; ++k) {
+        c[k].resize(n);
+        for (std::size_t p = 0; p < n; ++p)
+            c[k][p] = (k == 0) ? 10.0 + 0.01 * static_cast<double>(p)
+                               : -0.5 - 0.1 * static_cast<double>(k) - 0.001 * static_cast<double>(p);
+    }
+
+    SparseSquareMatrixCRSDouble S(n);
+    for (std::size_t z = 0; z < nz; ++z)
+        for (std::size_t y = 0; y < ny; ++y)
+            for (std::size_t xi = 0; xi < nx; ++xi) {
+                const std::size_t p = (z * ny + y) * nx + xi;
+                S.addEntry(p, p, c[0][p]);
+                if (xi > 0)      S.addEntry(p, p - 1, c[1][p]);
+                if (xi + 1 < nx) S.addEntry(p, p + 1, c[2][p]);
+                if (y > 0)       S.addEntry(p, p - nx, c[3][p]);
+                if (y + 1 < ny)  S.addEntry(p, p + nx, c[4][p]);
+                if (z > 0)       S.addEntry(p, p - nx * ny, c[5][p]);
+                if (z + 1 < nz)  S.addEntry(p, p + nx * ny, c[6][p]);
+            }
+    S.finalize();
+
+    StencilOperator7Double var7(nx, ny, nz, std::move(c));
+    expect_near(((var7 * x) - (S * x)).normInf(), 0.0, 1e-12, "Variable 7-point should match CRS");
+
+    // constant 27-point with all weights 1 sums the in-grid neighbourhood
+    StencilOperator27Double::Coefficients ones;
+    ones.fill(1.0);
+    StencilOperator27Double box(nx, ny, nz, ones);
+    VectorDouble one(n);
+    for (std::size_t i = 0; i < n; ++i)
+        one[i] = 1.0;
+    VectorDouble cnt = box * one;
+    expect_near(cnt[0], 8.0, 1e-12, "27-point corner count");
+    expect_near(cnt[(1 * ny + 1) * nx + 1], 27.0, 1e-12, "27-point interior count");
+
+    // CG on the 2D 5-point Laplacian, matrix-free vs assembled
+    const std::size_t m = 12;
+    auto lap = std::make_unique<StencilOperator7Double>(StencilOperator7Double::laplacian(m, m, 1, 1.0));
+    VectorDouble xe(m * m);
+    for (std::size_t i = 0; i < m * m; ++i)
+        xe[i] = std::sin(0.1 * static_cast<double>(i));
+    VectorDouble rhs = *lap * xe;
+
+    SparseSquareMatrixCRSDouble L(m * m);
+    for (std::size_t y = 0; y < m; ++y)
+        for (std::size_t xi = 0; xi < m; ++xi) {
+            const std::size_t p = y * m + xi;
+            L.addEntry(p, p, 4.0);
+            if (xi > 0)     L.addEntry(p, p - 1, -1.0);
+            if (xi + 1 < m) L.addEntry(p, p + 1, -1.0);
+            if (y > 0)      L.addEntry(p, p - m, -1.0);
+            if (y + 1 < m)  L.addEntry(p, p + m, -1.0);
+        }
+
+    LinearSystemOperator mf(std::move(lap), VectorDouble(m * m), VectorDouble(rhs));
+    LinearSystemOperator asm_(std::make_unique<SparseMatrixOperatorDouble>(std::move(L)),
+                              VectorDouble(m * m), std::move(rhs));
+
+    mf.solveCG(1e-12, 500);
+    asm_.solveCG(1e-12, 500);
+    expect_near((mf.x() - xe).normInf(), 0.0, 1e-9, "Matrix-free CG solution");
+    expect_near((asm_.x() - xe).normInf(), 0.0, 1e-9, "Assembled CG solution");
+    expect_near(mf.residual().normInf(), 0.0, 1e-9, "Matrix-free residual");
+
+    std::cout << "  OK\n";
+}
+
+static void test_dense_direct_solvers()
+{
+    std::cout << "Running test_dense_direct_solvers...\n";
+
+    const std::size_t N = 7;
+    DenseSquareMatrixDouble A(N);
+    VectorDouble xe(N);
+    for (std::size_t i = 0; i < N; ++i) {
+        for (std::size_t j = 0; j < N; ++j)
+            A(i, j) = 1.0 / static_cast<double>(i + j + 1);
+        A(i, i) += 2.0;
+        xe[i] = static_cast<double>(i) - 3.0;
+    }
+    VectorDouble b = A * xe;
+
+    // nonsymmetric copy with a zero leading pivot forces a row swap in LU
+    DenseSquareMatrixDouble P = A;
+    P(0, 0) = 0.0;
+    P(0, 3) = 5.0;
+    VectorDouble bp = P * xe;
+
+    // the stop hook is polled once per column (LU) or row (Cholesky)
+    for (int chol = 0; chol < 2; ++chol) {
+        std::size_t polls = 0;
+        auto stopAt3 = [&] { return ++polls == 3; };
+        bool stopped = false;
+        try {
+            if (chol)
+                DenseCholeskyDouble(A, stopAt3);
+            else
+                DenseLUDouble(P, stopAt3);
+        } catch (const FactorizationStopped&) {
+            stopped = true;
+        }
+        expect_true(stopped && polls == 3, "Factorization stops at the third poll");
+        polls = 0;
+        auto never = [&] { ++polls; return false; };
+        const VectorDouble xs = chol ? DenseCholeskyDouble(A, never).solve(b)
+                                     : DenseLUDouble(P, never).solve(bp);
+        expect_true(polls == N, "One poll per column");
+        expect_near((xs - xe).normInf(), 0.0, 1e-12, "Polled factorization solves");
+    }
+
+    LinearSystemDense lu(std::move(P), VectorDouble(N), std::move(bp));
+    lu.solveLU();
+    expect_near((lu.x() - xe).normInf(), 0.0, 1e-12, "Dense LU solution");
+
+    LinearSystemDense chol(std::move(A), VectorDouble(N), std::move(b));
+    chol.solveCholesky();
+    expect_near((chol.x() - xe).normInf(), 0.0, 1e-12, "Dense Cholesky solution");
+
+    std::cout << "  OK\n";
+}
+
+static void test_matrix_analysis_and_auto_solver()
+{
+    std::cout << "Running test_matrix_analysis_and_auto_solver...\n";
+
+    // small SPD dense -> dense Cholesky
+    {
+        const std::size_t N = 6;
+        DenseSquareMatrixDouble A(N);
+        VectorDouble b(N);
+        for (std::size_t i = 0; i < N; ++i) {
+            A(i, i) = 4.0;
+            if (i > 0) { A(i, i - 1) = -1.0; A(i - 1, i) = -1.0; }
+            b[i] = 1.0;
+        }
+        LinearSystemAuto sys(std::move(A), VectorDouble(N), std::move(b));
+        expect_true(sys.plan().format == StorageFormat::Dense, "Small matrix should stay dense");
+        expect_true(sys.plan().solver == SolverKind::Cholesky, "Small SPD matrix should use Cholesky");
+        expect_true(sys.analysis().bandwidth == 1, "Tridiagonal bandwidth");
+        expect_true(sys.analysis().nnz == 3 * N - 2, "Tridiagonal nnz");
+        expect_true(sys.analysis().diagonallyDominant, "Tridiagonal dominance");
+        sys.solve();
+        expect_near(sys.residual().normInf(), 0.0, 1e-12, "Auto Cholesky residual");
+    }
+
+    // mostly-zero dense, nonsymmetric -> CRS + GMRES
+    {
+        const std::size_t N = 200;
+        DenseSquareMatrixDouble A(N);
+        VectorDouble b(N);
+        for (std::size_t i = 0; i < N; ++i) {
+            A(i, i) = 4.0;
+            if (i > 0)     A(i, i - 1) = -1.5;
+            if (i + 1 < N) A(i, i + 1) = -0.5;
+            b[i] = std::sin(static_cast<double>(i));
+        }
+        LinearSystemAuto sys(std::move(A), VectorDouble(N), std::move(b));
+        expect_true(sys.plan().format == StorageFormat::CRS, "Sparse dense matrix should convert to CRS");
+        expect_true(sys.plan().solver == SolverKind::GMRES, "Nonsymmetric sparse should use GMRES");
+        expect_true(sys.analysis().minRowNnz == 2 && sys.analysis().maxRowNnz == 3, "Row length range");
+        sys.solve(1e-12);
+        expect_near(sys.residual().normInf(), 0.0, 1e-10, "Auto GMRES residual");
+    }
+
+    // 3x3 block tridiagonal SPD in CRS -> BSR(3) + CG
+    {
+        const std::size_t nb = 40, B = 3, N = nb * B;
+        SparseSquareMatrixCRSDouble A(N);
+        for (std::size_t ib = 0; ib < nb; ++ib)
+            for (std::size_t r = 0; r < B; ++r)
+                for (std::size_t c = 0; c < B; ++c) {
+                    const std::size_t i = ib * B + r;
+                    A.addEntry(i, ib * B + c, r == c ? 8.0 : 0.5);
+                    if (ib > 0)      A.addEntry(i, (ib - 1) * B + c, -1.0);
+                    if (ib + 1 < nb) A.addEntry(i, (ib + 1) * B + c, -1.0);
+                }
+        A.finalize();
+
+        VectorDouble xe(N);
+        for (std::size_t i = 0; i < N; ++i)
+            xe[i] = std::cos(0.2 * static_cast<double>(i));
+        VectorDouble b = A * xe;
+
+        LinearSystemAuto sys(std::move(A), VectorDouble(N), std::move(b));
+        expect_true(sys.analysis().blockSize == 3, "Block size detection");
+        expect_true(sys.plan().format == StorageFormat::BSR, "Blocked sparse should use BSR");
+        expect_true(sys.plan().solver == SolverKind::CG, "SPD sparse should use CG");
+        sys.solve(1e-12);
+        expect_near((sys.x() - xe).normInf(), 0.0, 1e-9, "Auto BSR CG solution");
+
+        // too few iterations is reported, not hidden by a switch to GMRES
+        sys.x() = VectorDouble(N);
+        bool threw = false;
+        try {
+            sys.solve(1e-12, 2);
+        } catch (const KrylovBreakdown&) {
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        expect_true(threw, "CG non-convergence should propagate");
+        expect_true(sys.plan().solver == SolverKind::CG, "Non-convergence should keep the CG plan");
+    }
+
+    // CG breakdown is its own exception type
+    {
+        const std::size_t N = 10;
+        DenseSquareMatrixDouble A(N);
+        for (std::size_t i = 0; i < N; ++i)
+            A(i, i) = -1.0;
+        DenseMatrixOperatorDouble op(std::move(A));
+        VectorDouble b(N), x(N);
+        b[0] = 1.0;
+        bool breakdown = false;
+        try {
+            solveCG(op, b, x);
+        } catch (const KrylovBreakdown&) {
+            breakdown = true;
+        }
+        expect_true(breakdown, "CG on a negative definite operator should throw KrylovBreakdown");
+    }
+
+    // dense <-> CRS round trip
+    {
+        DenseSquareMatrixDouble D(3);
+        D(0, 0) = 1.0; D(0, 2) = 2.0; D(2, 1) = -3.0;
+        SparseSquareMatrixCRSDouble S = SparseSquareMatrixCRSDouble::fromDense(D);
+        expect_true(S.nnz() == 2, "fromDense should keep only nonzero off-diagonals");
+        DenseSquareMatrixDouble R = S.toDense();
+        for (std::size_t i = 0; i < 3; ++i)
+            for (std::size_t j = 0; j < 3; ++j)
+                expect_near(R(i, j), D(i, j), 0.0, "Dense/CRS round trip");
+    }
+
+    std::cout << "  OK\n";
+}
+
+static void test_out_of_core_crs_streaming()
+{
+    std::cout << "Running test_out_of_core_crs_streaming...\n";
+
+    // 2D Laplacian on a 20 x 20 grid, streamed in small chunks
+    const std::size_t nx = 20, n = nx * nx;
+    SparseSquareMatrixCRSDouble A(n);
+    for (std::size_t y = 0; y < nx; ++y)
+        for (std::size_t xi = 0; xi < nx; ++xi) {
+            const std::size_t p = y * nx + xi;
+            A.addEntry(p, p, 4.0);
+            if (xi > 0)      A.addEntry(p, p - 1, -1.0);
+            if (xi + 1 < nx) A.addEntry(p, p + 1, -1.0);
+            if (y > 0)       A.addEntry(p, p - nx, -1.0);
+            if (y + 1 < nx)  A.addEntry(p, p + nx, -1.0);
+        }
+    A.finalize();
+
+    const std::string path = "test_ooc_crs.bin";
+    OutOfCoreSparseMatrixCRSDouble::write(path, A, 2048);
+
+    {
+        OutOfCoreSparseMatrixCRSDouble S(path);
+        expect_true(S.size() == n, "Out-of-core size");
+        expect_true(S.nnz() == A.nnz(), "Out-of-core nnz");
+        expect_true(S.numChunks() > 10, "Out-of-core file should be split into many chunks");
+
+        VectorDouble x(n);
+        for (std::size_t i = 0; i < n; ++i)
+            x[i] = std::sin(0.1 * static_cast<double>(i));
+        expect_near((S * x - A * x).normInf(), 0.0, 1e-13, "Streamed SpMV matches in-memory CRS");
+
+        VectorDouble b = A * x;
+        VectorDouble xs(n);
+        solveCG(S, b, xs, 1e-12, 1000);
+        expect_near((xs - x).normInf(), 0.0, 1e-9, "CG on streamed operator");
+    }
+
+    // rows written out of order are rejected, unfinished files cannot be opened
+    {
+        OutOfCoreSparseMatrixCRSDouble::Writer w(path, 4);
+        const std::size_t col = 1;
+        const double v = 1.0;
+        w.addRow(2, &col, &v, 1);
+        bool threw = false;
+        try { w.addRow(1, &col, &v, 1); } catch (const std::runtime_error&) { threw = true; }
+        expect_true(threw, "Writer should reject decreasing rows");
+    }
+    bool threw = false;
+    try { OutOfCoreSparseMatrixCRSDouble S(path); } catch (const std::runtime_error&) { threw = true; }
+    expect_true(threw, "Unfinished out-of-core file should not open");
+
+    // a corrupt column index or row pointer is caught before it is used.
+    // One chunk of 4 rows: header (5 words), diag (4), rowPtr (5), colInd.
+    for (int field = 0; field < 2; ++field) {
+        {
+            OutOfCoreSparseMatrixCRSDouble::Writer w(path, 4);
+            const std::size_t cols[2] = {0, 3};
+            const double vals[2] = {1.0, 2.0};
+            for (std::size_t i = 0; i < 4; ++i)
+                w.addRow(i, cols, vals, 2);
+            w.finish();
+        }
+        const long pos = field == 0 ? 14 * 8 : 10 * 8;  // colInd[0] / rowPtr[1]
+        const std::uint64_t bad = 1000;
+        std::FILE* f = std::fopen(path.c_str(), "r+b");
+        expect_true(f && std::fseek(f, pos, SEEK_SET) == 0
+                      && std::fwrite(&bad, sizeof(bad), 1, f) == 1, "Patch out-of-core file");
+        std::fclose(f);
+
+        OutOfCoreSparseMatrixCRSDouble S(path);
+        VectorDouble x(4), y(4);
+        threw = false;
+        try { S.apply(x, y); } catch (const std::runtime_error&) { threw = true; }
+        expect_true(threw, "Corrupt out-of-core chunk should throw");
+    }
+
+    // truncated files and absurd header or index values are rejected when
+    // the file is opened: N, numChunks, index offset, chunk rows, chunk offset
+    OutOfCoreSparseMatrixCRSDouble::write(path, A, 2048);
+    std::vector<char> good;
+    {
+        std::FILE* f = std::fopen(path.c_str(), "rb");
+        char buf[4096];
+        std::size_t r;
+        while (f && (r = std::fread(buf, 1, sizeof(buf), f)) > 0)
+            good.insert(good.end(), buf, buf + r);
+        if (f) std::fclose(f);
+    }
+    std::uint64_t indexOffset;
+    std::memcpy(&indexOffset, &good[4 * 8], 8);
+    const std::size_t patches[5] = {1 * 8, 3 * 8, 4 * 8,
+                                    static_cast<std::size_t>(indexOffset) + 1 * 8,
+                                    static_cast<std::size_t>(indexOffset) + 3 * 8};
+    for (int variant = -2; variant < 5; ++variant) {
+        std::vector<char> bytes = good;
+        if (variant == -2) {
+            bytes.resize(20);              // shorter than the header
+        } else if (variant == -1) {
+            bytes.resize(bytes.size() - 8);  // index cut short
+        } else {
+            const std::uint64_t bad = variant == 2 ? good.size() - 8
+                                                   : std::uint64_t(1) << 62;
+            std::memcpy(&bytes[patches[variant]], &bad, 8);
+        }
+        std::FILE* f = std::fopen(path.c_str(), "wb");
+        expect_true(f && std::fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size(),
+                    "Write damaged out-of-core file");
+        std::fclose(f);
+
+        threw = false;
+        try { OutOfCoreSparseMatrixCRSDouble S(path); } catch (const std::runtime_error&) { threw = true; }
+        expect_true(threw, "Damaged out-of-core header or index should not open");
+    }
+
+    std::remove(path.c_str());
+    std::cout << "  OK\n";
+}
+
+static void test_numa_first_touch()
+{
+    std::cout << "Running test_numa_first_touch...\n";
+
+    expect_true(numaNodeCount() >= 1, "At least one NUMA node");
+    const ComputePool& pool = ComputePool::instance();
+    expect_true(pool.pinnedCpus().empty() || pool.pinnedCpus().size() == pool.numThreads(),
+                "One pinned CPU per pool thread");
+
+    // large enough for the parallel first-touch path
+    const std::size_t n = 3 * kFirstTouchMin + 7;
+    VectorDouble v(n);
+    expect_near(v.normInf(), 0.0, 0.0, "First-touched vector is zero");
+    for (std::size_t i = 0; i < n; ++i)
+        v[i] = static_cast<double>(i % 97);
+    VectorDouble w(v);
+    expect_near((w - v).normInf(), 0.0, 0.0, "First-touched copy");
+    const std::size_t bytes = w.size() * sizeof(double);
+    const bool bound = numaBind(w.data(), bytes, 0);
+    expect_near((w - v).normInf(), 0.0, 0.0, "Binding keeps contents");
+#if defined(__linux__)
+    // node 0 always exists; only a kernel without mbind (or one that forbids
+    // it) refuses, and then every bind fails
+    if (bound)
+        expect_true(numaBind(w.data(), bytes, 0), "Binding is repeatable");
+#else
+    expect_false(bound, "numaBind is unsupported off Linux");
+#endif
+    // refusals report false and leave the memory usable
+    expect_false(numaBind(w.data(), 16, 0), "Less than a page cannot be bound");
+    expect_false(numaBind(w.data(), bytes, -1), "Negative node");
+    expect_false(numaBind(w.data(), bytes, numaNodeCount() + 512), "Node that does not exist");
+    expect_false(numaBind(nullptr, bytes, 0), "Null pointer");
+    expect_near((w - v).normInf(), 0.0, 0.0, "Refused binds keep contents");
+
+#ifdef __linux__
+    // parallelFor pins the calling thread only for its own chunk
+    cpu_set_t before, after;
+    CPU_ZERO(&before);
+    CPU_ZERO(&after);
+    expect_true(sched_getaffinity(0, sizeof(before), &before) == 0, "Read caller affinity");
+    parallelFor(n, kRowGrain, [&](std::size_t i0, std::size_t i1) {
+        for (std::size_t i = i0; i < i1; ++i)
+            w[i] += 1.0;
+    });
+    expect_true(sched_getaffinity(0, sizeof(after), &after) == 0, "Read caller affinity");
+    expect_true(CPU_EQUAL(&before, &after), "parallelFor restores the caller's affinity");
+#endif
+
+    const std::size_t N = 200;
+    DenseSquareMatrixDouble D(N);
+    for (std::size_t i = 0; i < N; ++i)
+        for (std::size_t j = 0; j < N; ++j)
+            D(i, j) = (i == j) ? 4.0 : ((i + 2 * j) % 11 == 0 ? 0.5 : 0.0);
+    DenseSquareMatrixDouble E = D;
+    E = D;
+    double diff = 0.0;
+    for (std::size_t i = 0; i < N; ++i)
+        for (std::size_t j = 0; j < N; ++j)
+            diff = std::max(diff, std::abs(E(i, j) - D(i, j)));
+    expect_near(diff, 0.0, 0.0, "First-touched dense copy");
+
+    // row-parallel CRS build: duplicates, empty rows, diagonal-only rows
+    SparseSquareMatrixCRSDouble S(N);
+    for (std::size_t i = 0; i < N; ++i) {
+        if (i % 13 == 5)
+            continue;
+        for (std::size_t j = 0; j < N; ++j)
+            if (D(i, j) != 0.0 && i != j) {
+                S.addEntry(i, j, 0.25);
+                S.addEntry(i, j, 0.25);
+            }
+        S.addEntry(i, i, 4.0);
+    }
+    S.finalize();
+
+    VectorDouble x(N);
+    for (std::size_t i = 0; i < N; ++i)
+        x[i] = std::cos(0.3 * static_cast<double>(i));
+    VectorDouble yS = S * x;
+    VectorDouble yD = D * x;
+    double err = 0.0;
+    for (std::size_t i = 0; i < N; ++i)
+        if (i % 13 != 5)
+            err = std::max(err, std::abs(yS[i] - yD[i]));
+        else
+            err = std::max(err, std::abs(yS[i]));
+    expect_near(err, 0.0, 1e-13, "Row-parallel CRS build and SpMV");
+
+    // the first-touched arrays behind both accessor forms
+    const std::vector<std::size_t>& rp = S.rowPtr();
+    const std::vector<std::size_t> ci = S.colInd();
+    const std::vector<double> va = S.values();
+    expect_true(S.isFinalized() && rp.size() == N + 1 && rp[N] == S.nnz(), "CRS rowPtr copy");
+    expect_true(std::equal(rp.begin(), rp.end(), S.rowPtrData())
+                && std::equal(ci.begin(), ci.end(), S.colIndData())
+                && va.size() == S.nnz()
+                && std::equal(va.begin(), va.end(), S.valuesData()),
+                "CRS copies match the raw arrays");
+    SparseSquareMatrixCRSDouble F = SparseSquareMatrixCRSDouble::fromDense(D);
+    expect_near((F * x - yD).normInf(), 0.0, 1e-13, "First-touched fromDense SpMV");
+
+    std::cout << "  OK\n";
+}
+
+static void test_solve_service_async()
+{
+    std::cout << "Running test_solve_service_async...\n";
+
+    // one small SPD dense matrix, many right-hand sides in flight at once
+    const std::size_t N = 12;
+    auto D = std::make_shared<DenseSquareMatrixDouble>(N);
+    for (std::size_t i = 0; i < N; ++i) {
+        (*D)(i, i) = 5.0;
+        if (i > 0) { (*D)(i, i - 1) = -1.0; (*D)(i - 1, i) = -1.0; }
+    }
+
+    // 2D Laplacian, large enough for the pool-owning lane with largeWork = 500
+    const std::size_t nx = 16, n = nx * nx;
+    SparseSquareMatrixCRSDouble L(n);
+    for (std::size_t y = 0; y < nx; ++y)
+        for (std::size_t xi = 0; xi < nx; ++xi) {
+            const std::size_t p = y * nx + xi;
+            L.addEntry(p, p, 4.0);
+            if (xi > 0)      L.addEntry(p, p - 1, -1.0);
+            if (xi + 1 < nx) L.addEntry(p, p + 1, -1.0);
+            if (y > 0)       L.addEntry(p, p - nx, -1.0);
+            if (y + 1 < nx)  L.addEntry(p, p + nx, -1.0);
+        }
+    L.finalize();
+    auto S = std::make_shared<SparseSquareMatrixCRSDouble>(std::move(L));
+
+    {
+        SolveService service(3, 500);
+
+        std::vector<VectorDouble> xs;
+        std::vector<SolveService::Handle> handles;
+        for (std::size_t k = 0; k < 16; ++k) {
+            VectorDouble xe(N);
+            for (std::size_t i = 0; i < N; ++i)
+                xe[i] = std::sin(static_cast<double>(k + i));
+            handles.push_back(service.submit(D, (*D) * xe));
+            xs.push_back(std::move(xe));
+        }
+        VectorDouble xl(n);
+        for (std::size_t i = 0; i < n; ++i)
+            xl[i] = std::cos(0.05 * static_cast<double>(i));
+        SolveOptions cg;
+        cg.relTol = 1e-12;
+        SolveService::Handle hl = service.submit(S, (*S) * xl, cg);
+
+        std::size_t built = 0;
+        for (std::size_t k = 0; k < handles.size(); ++k) {
+            SolveResult r = handles[k].get();
+            expect_true(r.status == SolveStatus::Converged, "Dense job converged");
+            expect_true(r.solver == SolverKind::Cholesky, "SPD dense job uses Cholesky");
+            expect_near((r.x - xs[k]).normInf(), 0.0, 1e-12, "Dense job solution");
+            built += r.reused ? 0 : 1;
+        }
+        expect_true(built == 1, "Factorization built once and shared");
+
+        SolveResult rl = hl.get();
+        expect_true(rl.solver == SolverKind::CG && rl.iterations > 0, "Sparse SPD job uses CG");
+        expect_near((rl.x - xl).normInf(), 0.0, 1e-9, "Sparse job solution");
+        SolveResult rl2 = service.submit(S, (*S) * xl, cg).get();
+        expect_true(rl2.reused, "Preconditioner reused for the same matrix");
+        expect_true(service.cachedMatrices() == 2, "Two matrices cached");
+
+        // singular matrix: failures come back through the future
+        auto Z = std::make_shared<DenseSquareMatrixDouble>(3);
+        SolveOptions lu;
+        lu.method = SolveMethod::LU;
+        SolveService::Handle hz = service.submit(Z, VectorDouble(3), lu);
+        bool threw = false;
+        try { hz.get(); } catch (const std::runtime_error&) { threw = true; }
+        expect_true(threw, "Singular job reports its error");
+
+        // expired deadline never runs
+        SolveOptions late;
+        late.deadline = SolveService::Clock::now() - std::chrono::milliseconds(1);
+        expect_true(service.submit(D, VectorDouble(N), late).get().status == SolveStatus::DeadlineExpired,
+                    "Expired job is not run");
+    }
+
+    // cancellation of a running and of a queued job on a single worker
+    {
+        SolveService service(1, std::size_t(1) << 30);
+        SolveOptions forever;
+        forever.method = SolveMethod::GMRES;
+        forever.relTol = 0.0;
+        forever.maxIter = std::size_t(1) << 40;
+
+        VectorDouble b(n);
+        for (std::size_t i = 0; i < n; ++i)
+            b[i] = 1.0 + std::sin(static_cast<double>(i));
+        SolveService::Handle running = service.submit(S, b, forever);
+        SolveService::Handle queued = service.submit(D, VectorDouble(N));
+        queued.cancel();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        running.cancel();
+
+        expect_true(running.get().status == SolveStatus::Cancelled, "Running job cancelled");
+        expect_true(queued.get().status == SolveStatus::Cancelled, "Queued job cancelled");
+    }
+
+    // cache entries go with their matrix, without another submit
+    {
+        SolveService service(1, std::size_t(1) << 30);
+
+        // dropped while its job is in flight: gone once the future is ready
+        auto A = std::make_shared<DenseSquareMatrixDouble>(*D);
+        std::weak_ptr<const DenseSquareMatrixDouble> wA = A;
+        SolveService::Handle h = service.submit(A, VectorDouble(N));
+        A.reset();
+        expect_true(h.get().status == SolveStatus::Converged, "Job on a dropped matrix runs");
+        expect_true(wA.expired(), "Finished job releases its matrix");
+        expect_true(service.cachedMatrices() == 0, "Entry freed with the job's last reference");
+
+        // dropped after its job finished
+        auto B = std::make_shared<DenseSquareMatrixDouble>(*D);
+        service.submit(B, VectorDouble(N)).get();
+        expect_true(service.cachedMatrices() == 1, "Entry kept while the matrix lives");
+        B.reset();
+        expect_true(service.cachedMatrices() == 0, "Entry freed once the matrix is dropped");
+
+        // CG that runs out of iterations is an error, not a switch to GMRES
+        SolveOptions few;
+        few.method = SolveMethod::Auto;
+        few.relTol = 1e-14;
+        few.maxIter = 2;
+        VectorDouble b(n);
+        for (std::size_t i = 0; i < n; ++i)
+            b[i] = 1.0;
+        SolveService::Handle hf = service.submit(S, b, few);
+        service.submit(D, VectorDouble(N)).get();  // one worker: hf's job is retired
+        std::string what;
+        try {
+            hf.get();
+        } catch (const KrylovBreakdown&) {
+        } catch (const std::runtime_error& e) {
+            what = e.what();
+        }
+        expect_true(what.find("CG did not converge") != std::string::npos,
+                    "Non-converged Auto CG job reports the CG error");
+    }
+
+    // Auto follows selectSolverPlan: a small SPD CRS matrix is factored
+    {
+        SolveService service(2, std::size_t(1) << 30);
+        const std::size_t m = 30;
+        SparseSquareMatrixCRSDouble T(m);
+        for (std::size_t i = 0; i < m; ++i) {
+            T.addEntry(i, i, 3.0);
+            if (i > 0) { T.addEntry(i, i - 1, -1.0); T.addEntry(i - 1, i, -1.0); }
+        }
+        T.finalize();
+        auto Ts = std::make_shared<SparseSquareMatrixCRSDouble>(std::move(T));
+        VectorDouble xe(m);
+        for (std::size_t i = 0; i < m; ++i)
+            xe[i] = 1.0 / static_cast<double>(i + 1);
+        SolveResult r = service.submit(Ts, (*Ts) * xe).get();
+        expect_true(r.solver == SolverKind::Cholesky && r.iterations == 0,
+                    "Small SPD CRS matrix is factored under Auto");
+        expect_near((r.x - xe).normInf(), 0.0, 1e-12, "Auto direct solve of a CRS matrix");
+    }
+
+    // a factorization stopped by its deadline is not cached; the next job
+    // for the same matrix builds it again
+    {
+        SolveService service(1, std::size_t(1) << 30);
+        const std::size_t m = 600;
+        auto G = std::make_shared<DenseSquareMatrixDouble>(m);
+        for (std::size_t i = 0; i < m; ++i)
+            for (std::size_t j = 0; j < m; ++j)
+                (*G)(i, j) = i == j ? 2.0 * static_cast<double>(m) : std::sin(static_cast<double>(i + 3 * j));
+        VectorDouble xe(m);
+        for (std::size_t i = 0; i < m; ++i)
+            xe[i] = std::cos(static_cast<double>(i));
+        const VectorDouble b = (*G) * xe;
+
+        SolveOptions lu;
+        lu.method = SolveMethod::LU;
+        SolveOptions soon = lu;
+        soon.deadline = SolveService::Clock::now() + std::chrono::milliseconds(2);
+        expect_true(service.submit(G, b, soon).get().status == SolveStatus::DeadlineExpired,
+                    "Deadline stops the factorization");
+        SolveResult r = service.submit(G, b, lu).get();
+        expect_true(r.status == SolveStatus::Converged && !r.reused,
+                    "Stopped factorization is rebuilt by the next job");
+        expect_near((r.x - xe).normInf(), 0.0, 1e-10, "Rebuilt factorization solves");
+        expect_true(service.submit(G, b, lu).get().reused, "Completed factorization is reused");
+    }
+
+    std::cout << "  OK\n";
+}
+
+template <std::size_t N>
+static void check_fixed_size_system()
+{
+    FixedSquareMatrixDouble<N> A;
+    FixedVectorDouble<N> xe;
+    for (std::size_t i = 0; i < N; ++i) {
+        for (std::size_t j = 0; j < N; ++j)
+            A(i, j) = std::sin(static_cast<double>(3 * i + 7 * j + 1));
+        A(i, i) += 0.5 * static_cast<double>(N);
+        xe[i] = 1.0 + static_cast<double>(i);
+    }
+    // zero leading entry forces a pivot swap in the LU path
+    if (N > 1)
+        A(0, 0) = 0.0;
+
+    const DenseSquareMatrixDouble D = A.toDense();
+    const FixedVectorDouble<N> b = A * xe;
+    expect_near((b.toVector() - D * xe.toVector()).normInf(), 0.0, 1e-12, "Fixed A*x matches dense");
+
+    const FixedVectorDouble<N> x = A.solve(b);
+    expect_near((x - xe).normInf(), 0.0, 1e-10, "Fixed-size solve");
+    expect_near(A.residual(x, b).normInf(), 0.0, 1e-10, "Fixed-size residual");
+    expect_near((x.toVector() - DenseLUDouble(D).solve(b.toVector())).normInf(), 0.0, 1e-10,
+                "Fixed-size solve matches DenseLUDouble");
+
+    // det(A B) = det(A) det(B), det(2 I) = 2^N
+    const FixedSquareMatrixDouble<N> B = FixedSquareMatrixDouble<N>::identity() * 2.0 + A * 0.25;
+    const double detAB = (A * B).determinant();
+    expect_near(detAB, A.determinant() * B.determinant(), 1e-9 * std::abs(detAB) + 1e-12,
+                "Fixed-size determinant is multiplicative");
+    expect_near((FixedSquareMatrixDouble<N>::identity() * 2.0).determinant(),
+                std::pow(2.0, static_cast<double>(N)), 1e-12, "Fixed-size determinant of 2I");
+
+    const FixedSquareMatrixDouble<N> R(D);
+    for (std::size_t i = 0; i < N; ++i)
+        for (std::size_t j = 0; j < N; ++j)
+            expect_near(R(i, j), A(i, j), 0.0, "Dense round trip");
+
+    FixedSquareMatrixDouble<N> S = A;
+    for (std::size_t j = 0; j < N; ++j)
+        S(N - 1, j) = 0.0;
+    expect_near(S.determinant(), 0.0, 0.0, "Determinant with a zero row");
+    bool threw = false;
+    try { S.solve(b); } catch (const std::runtime_error&) { threw = true; }
+    expect_true(threw, "Singular fixed-size system should throw");
+}
+
+static void test_fixed_size_small_systems()
+{
+    std::cout << "Running test_fixed_size_small_systems...\n";
+
+    check_fixed_size_system<1>();
+    check_fixed_size_system<2>();
+    check_fixed_size_system<3>();
+    check_fixed_size_system<4>();
+    check_fixed_size_system<5>();
+    check_fixed_size_system<8>();
+
+    bool threw = false;
+    try { FixedVectorDouble<3> v{VectorDouble(4)}; (void)v; } catch (const std::runtime_error&) { threw = true; }
+    expect_true(threw, "Size mismatch converting to FixedVectorDouble");
+
+    // normInf propagates NaN wherever it sits, as VectorDouble::normInf does
+    for (std::size_t k = 0; k < 4; ++k) {
+        FixedVectorDouble<4> v;
+        for (std::size_t i = 0; i < 4; ++i)
+            v[i] = -static_cast<double>(i + 1);
+        v[k] = std::nan("");
+        expect_true(std::isnan(v.normInf()), "Fixed normInf propagates NaN");
+    }
+
+    std::cout << "  OK\n";
+}
+
 int main()
 {
     try {
@@ -227,6 +1421,18 @@ int main()
         test_dense_matrix_matrix_mult();
         test_linear_system_multiply_residual();
         test_symmetry_and_diag_dominance();
+        test_bsr_mv_and_block_jacobi();
+        test_simd_dispatch_levels();
+        test_compute_pool_parallel_for();
+        test_batched_dense_solve();
+        test_structure_checks_tiled_and_sparse();
+        test_stencil_operators_matrix_free();
+        test_dense_direct_solvers();
+        test_matrix_analysis_and_auto_solver();
+        test_out_of_core_crs_streaming();
+        test_numa_first_touch();
+        test_solve_service_async();
+        test_fixed_size_small_systems();
 
         std::cout << "\nAll tests PASSED\n";
         return 0;
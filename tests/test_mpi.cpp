@@ -0,0 +1,134 @@
+// Distributed sparse tests, run with several ranks on one machine:
+//   mpicxx -std=c++17 -O2 -DLA_WITH_MPI -Iinclude src/*.cpp tests/test_mpi.cpp -o test_mpi
+//   mpirun -np 4 ./test_mpi
+#include <iostream>
+#include <cmath>
+#include <stdexcept>
+#include <mpi.h>
+
+#include "SparseSquareMatrixCRSDouble.hpp"
+#include "DistributedVectorDouble.hpp"
+#include "DistributedSparseMatrixCRSDouble.hpp"
+#include "LinearSystemSparseDistributed.hpp"
+
+static int g_rank = 0;
+
+static void expect_near(double a, double b, double tol, const char* msg)
+{
+    if (std::abs(a - b) > tol) {
+        std::cerr << "[FAIL rank " << g_rank << "] " << msg << " | got " << a
+                  << " expected " << b << " (tol=" << tol << ")\n";
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+}
+
+static void expect_true(bool cond, const char* msg)
+{
+    if (!cond) {
+        std::cerr << "[FAIL rank " << g_rank << "] " << msg << "\n";
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+}
+
+// 2D 5-point Laplacian on an m x m grid, so rows couple to ranks m rows away
+static double laplace(std::size_t m, std::size_t i, std::size_t j)
+{
+    if (i == j) return 4.0;
+    const std::size_t d = i > j ? i - j : j - i;
+    if (d == m) return -1.0;
+    if (d == 1 && std::min(i, j) / m == std::max(i, j) / m) return -1.0;
+    return 0.0;
+}
+
+static void test_distributed_spmv_matches_serial()
+{
+    if (g_rank == 0)
+        std::cout << "Running test_distributed_spmv_matches_serial...\n";
+
+    const std::size_t m = 9, N = m * m;
+
+    SparseSquareMatrixCRSDouble S(N);
+    DistributedSparseMatrixCRSDouble A(MPI_COMM_WORLD, N);
+    for (std::size_t i = 0; i < N; ++i)
+        for (std::size_t j : {i - m, i - 1, i, i + 1, i + m}) {
+            if (j >= N || laplace(m, i, j) == 0.0) continue;
+            S.addEntry(i, j, laplace(m, i, j));
+            if (i >= A.rowBegin() && i < A.rowEnd())
+                A.addEntry(i, j, laplace(m, i, j));
+        }
+    S.finalize();
+    A.finalize();
+
+    VectorDouble xs(N);
+    DistributedVectorDouble x(MPI_COMM_WORLD, N);
+    for (std::size_t i = 0; i < N; ++i)
+        xs[i] = std::sin(0.3 * static_cast<double>(i));
+    for (std::size_t i = 0; i < x.localSize(); ++i)
+        x[i] = xs[x.rowBegin() + i];
+
+    VectorDouble ys = S * xs;
+    DistributedVectorDouble y = A * x;
+    for (std::size_t i = 0; i < y.localSize(); ++i)
+        expect_near(y[i], ys[y.rowBegin() + i], 1e-12, "Distributed SpMV should match serial");
+
+    expect_near(x.dot(y), xs.dot(ys), 1e-10, "Global dot should match serial");
+    expect_near(y.normInf(), ys.normInf(), 1e-12, "Global normInf should match serial");
+
+    int P = 1;
+    MPI_Comm_size(MPI_COMM_WORLD, &P);
+    if (P > 1)
+        expect_true(A.numGhosts() > 0, "Partitioned Laplacian should have ghost columns");
+
+    if (g_rank == 0)
+        std::cout << "  OK\n";
+}
+
+static void test_distributed_cg()
+{
+    if (g_rank == 0)
+        std::cout << "Running test_distributed_cg...\n";
+
+    const std::size_t m = 16, N = m * m;
+
+    DistributedSparseMatrixCRSDouble A(MPI_COMM_WORLD, N);
+    DistributedVectorDouble xe(MPI_COMM_WORLD, N);
+    for (std::size_t i = A.rowBegin(); i < A.rowEnd(); ++i) {
+        for (std::size_t j : {i - m, i - 1, i, i + 1, i + m})
+            if (j < N && laplace(m, i, j) != 0.0)
+                A.addEntry(i, j, laplace(m, i, j));
+        xe[i - A.rowBegin()] = std::cos(0.05 * static_cast<double>(i));
+    }
+    A.finalize();
+
+    DistributedVectorDouble b = A * xe;
+    LinearSystemSparseDistributed sys(std::move(A), DistributedVectorDouble(MPI_COMM_WORLD, N), std::move(b));
+
+    sys.solveCG(1e-12, 1000);
+    expect_near((sys.x() - xe).normInf(), 0.0, 1e-9, "Distributed CG solution");
+    expect_near(sys.residual().normInf(), 0.0, 1e-9, "Distributed CG residual");
+
+    if (g_rank == 0)
+        std::cout << "  OK\n";
+}
+
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &g_rank);
+
+    int rc = 0;
+    try {
+        test_distributed_spmv_matches_serial();
+        test_distributed_cg();
+
+        if (g_rank == 0)
+            std::cout << "\nAll MPI tests PASSED\n";
+    }
+    catch (const std::exception& e) {
+        std::cerr << "[EXCEPTION rank " << g_rank << "] " << e.what() << "\n";
+        rc = 1;
+    }
+
+    MPI_Finalize();
+    return rc;
+}